@@ -19,8 +19,18 @@
  *
  *          May 22 09:13 2012 -- Added recognition of negative numbers.
  *
+ *          Oct 18 2026 -- GetInt replaced by GetInt64 so that microsecond
+ *                         timestamps spanning days can be parsed.
+ *
+ *          Oct 18 2026 -- Added WarningMsg for errors the program can
+ *                         recover from.
+ *
+ *          Oct 18 2026 -- GetInt64 returns a status and stores the value,
+ *                         so EOF and overflow are no longer numbers.
+ *
  * Error handling:
- *          None
+ *          GetInt64 returns EXIT_FAILURE for values that do not fit in
+ *          64 bits, callers have to reject them
  *
  * Notes:
  *          Support routine that reads an ASCII file and returns an
@@ -33,50 +43,59 @@
 #include <stdlib.h>           /* Used for getc() and feof() functions */
 #include <ctype.h>                 /* Used for the isdigit() function */
 #include <stdio.h>                    /* Used to handle the FILE type */
+#include <stdint.h>            /* Used for int64_t and the INT64_MAX */
 #include "FileIO.h"                                /* Function header */
 
 /*
  *
- *  Function: GetInt
+ *  Function: GetInt64
  *
- *  Purpose: The function will read the input file and return an integer
- *           representing the ASCII characters that form a number. It
- *           skips over comments, which begin a line with a #, and other
+ *  Purpose: The function will read the input file and return a 64-bit
+ *           integer representing the ASCII characters that form a number.
+ *           It skips over comments, which begin a line with a #, and other
  *           ASCI characters that do not represent numbers.
  *
  *  Parameters:
- *            input    Pointer to the text file to parse 
+ *            input    Pointer to the text file to parse and where to
+ *                     store the value read
  *
- *            output   Integer representing value, only positive values
- *                     are possible. If the end of file is reached a -1
- *                     is returned.
+ *            output   EXIT_SUCCESS if a number was read, EOF if the end
+ *                     of file was reached first and EXIT_FAILURE if the
+ *                     number does not fit in 64 bits. Every value can be
+ *                     read, the status is never mistaken for a number.
  *
  */
-int GetInt (FILE *fp) {
-    int	c,i;	   /* Character read and integer representation of it */
+int GetInt64 (FILE *fp, int64_t *value) {
+    int	c;	                                    /* Character read */
+    int64_t i;	                 /* Integer representation of number */
     int sign = 1;
+    int status = EXIT_SUCCESS;
     
     do { 
         c = getc (fp);                          /* Get next character */
         if ( c == '#' )	                          /* Skip the comment */
             do {
                 c = getc (fp);
-            } while ( c != '\n');
+            } while ( c != '\n' && c != EOF);
         if ( c == '-')
             sign = -1;
     } while (!isdigit(c) && !feof(fp));
     
     if (feof(fp)){
-        return (EXIT_FAILURE);
+        return (EOF);
     } else {
     /* Found 1st digit, begin conversion until a non-digit is found */
         i = 0;
         while (isdigit (c) && !feof(fp)){
-            i = (i*10) + (c - '0');
+            if (i > (INT64_MAX - (c - '0')) / 10)  /* Would overflow */
+                status = EXIT_FAILURE;     /* Keep reading its digits */
+            else
+                i = (i*10) + (c - '0');
             c = getc (fp);
         }
         
-        return (i*sign);
+        *value = i*sign;
+        return (status);
     }
 }
 
@@ -98,4 +117,23 @@ void ErrorMsg (char * function, char *message){
     printf ("\nError in function %s\n", function);
     printf ("\t %s\n", message);
     printf ("The program will terminate.\n\n");
+}
+
+/*
+ *
+ *  Function: WarningMsg
+ *
+ *  Purpose: Prints a warning for a problem the program recovers from,
+ *           it does not terminate.
+ *
+ *  Parameters:
+ *            input    String with the warning message
+ *
+ *            output   Prints the warning in standard error
+ *
+ */
+void WarningMsg (char * function, char *message){
+    
+    fprintf (stderr, "\nWarning in function %s\n", function);
+    fprintf (stderr, "\t %s\n\n", message);
 }
\ No newline at end of file
@@ -20,6 +20,14 @@
  *
  *          May 22 09:13 2012 -- Added recognition of negative numbers.
  *
+ *          Oct 18 2026 -- GetInt replaced by GetInt64, callers need to
+ *                         include <stdint.h> before this header.
+ *
+ *          Oct 18 2026 -- Added WarningMsg.
+ *
+ *          Oct 18 2026 -- GetInt64 returns EXIT_SUCCESS, EOF or, for
+ *                         values that do not fit, EXIT_FAILURE.
+ *
  * Error handling:
  *          None
  *
@@ -34,8 +42,9 @@
  *             Declare the function prototypes                * 
  **************************************************************/
 
-int  GetInt (FILE *fp);
+int GetInt64 (FILE *fp, int64_t *value);
 void ErrorMsg (char * function, char *message);
+void WarningMsg (char * function, char *message);
 
 
 
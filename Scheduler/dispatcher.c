@@ -29,10 +29,36 @@
  *
  *          Oct  1  --  Optimized the code, now we copy the list to be able to handle the processes in a more elegant and efficient way
  *
+ *          Oct 18  --  Simulated time, bursts and wait sums are now 64-bit, compare functions no longer subtract,
+ *                      idle gaps are skipped in one step instead of one time unit at a time
+ *
+ *          Oct 18  --  Added SetCheckpoint and ClearCheckpoint, Preemptive and RoundRobin periodically save their
+ *                      state and every algorithm saves its result so an interrupted run can be resumed
+ *
+ *          Oct 18  --  Algorithms return the average wait time instead of printing it and can record the completion
+ *                      time of every process, used to check engine.c against them
+ *
+ *          Oct 18  --  Processes are no longer changed once loaded, the algorithms share them through shallow copies of
+ *                      the list and keep burstLeft and the moved RoundRobin arrivals in a per-run Overlay array
+ *
+ *          Oct 18  --  Added ProcessFields, used to write the results of every process
+ *
+ *          Oct 18  --  A checkpoint is only resumed if its counts, indexes, bursts left and checksum are valid,
+ *                      problems with checkpoint files are warnings instead of errors
+ *
+ *          Oct 18  --  Added LoadProcessList, the only reader of input files, used by main and the daemon.
+ *                      SortProcessList is internal to it
+ *
+ *          Oct 18  --  LoadProcessList rejects numbers that do not fit in 64 bits and files whose times or wait sums
+ *                      would overflow, a quantum of 1 is no longer taken for the end of the file
+ *
+ *          Oct 18  --  Each run keeps its order in an array of pointers to the shared processes instead of a copy of
+ *                      the list, a checkpoint saves that order. Processes are const once LoadProcessList returns
+ *
  *
  * Error handling:
- *          None
- *			(The only error that could happen is if the timePassed variable reaches INT_MAX)
+ *          LoadProcessList returns EXIT_FAILURE for files the algorithms can not run
+ *			(Time is 64-bit and LoadProcessList rejects files whose times or wait sums would overflow it)
  *
  * Notes:
  *          We could modify the RoundRobin function for moving a process from its position to the last instead of eliminating and appending to the list
@@ -44,23 +70,50 @@
 #include <stdlib.h>                     /* Used for malloc definition */
 #include <stdio.h>                                /* Used for printf */
 #include <string.h>                                /* Used for strcmp */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <limits.h>                  /* Used for INT_MIN and INT_MAX */
+#include <inttypes.h>                 /* Used for the PRId64 format */
+#include <time.h>                    /* Used for checkpoint intervals */
+#include <unistd.h>                            /* Used for fsync */
+#include "FileIO.h"                   /* Used for GetInt64 and ErrorMsg */
+#include "dispatcher.h"               /* Used for Policy and COMPARE */
+
+#define NUMVAL    4                    /* Numbers that describe a process */
 
 
 //Definition of the structure: Process
+//Once the list is loaded processes are never changed, every algorithm reads the same ones
 typedef struct {
 	
 	int pid;
-	int arriveTime;
-	int burst;
+	int64_t arriveTime;
+	int64_t burst;
 	int priority;
 	
-	int burstLeft;   		/* This is used as a copy of burst to be able to alter its value without losing its initial value*/
-	int firstArriveTime; 	/* This is used in the roundRobin Algorithm to keep track of the true arrivalTime since we change the other variable*/
+	int index;				/* Position of the process in the list, used to find its Overlay and record its completion time */
 		
 }Process;
 
+//Definition of the structure: Overlay
+//The part of a process an algorithm changes, each run has an array of them indexed by Process index
+typedef struct {
+	
+	int64_t burstLeft;   		/* This is used as a copy of burst to be able to alter its value without losing its initial value*/
+	int64_t arriveTime; 		/* This is used in the roundRobin Algorithm to move the arrival of a process, the Process keeps the true one*/
+		
+}Overlay;
+
+//Definition of the structure: SortBy
+//Compare function and overlay used to sort the order of a run
+typedef struct {
+	
+	GCompareDataFunc compare;
+	const Overlay *overlay;
+		
+}SortBy;
+
 // Create a new process for the list: allocate memory and assign values
-Process *newProcess(int pid, int arriveTime, int burst, int priority, int burstLeft)
+Process *newProcess(int pid, int64_t arriveTime, int64_t burst, int priority, int index)
 {
     Process *process = malloc(sizeof(Process));
     //Process *process = g_new(Process, 1);
@@ -70,64 +123,137 @@ Process *newProcess(int pid, int arriveTime, int burst, int priority, int burstL
     process->burst = burst;
     process->priority = priority;
     
-    process->burstLeft = burst;
-    process->firstArriveTime = arriveTime;
+    process->index = index;
     
     return(process);
 }
 
+// Create the overlay of a run, every process starts with its whole burst and its true arrival
+static Overlay *newOverlay(GList *list, int size)
+{
+    Overlay *overlay = g_new(Overlay, size);
+    GList *current;
+    
+    for (current = list; current; current = current->next) {
+        overlay[((const Process*)current->data)->index].burstLeft = ((const Process*)current->data)->burst;
+        overlay[((const Process*)current->data)->index].arriveTime = ((const Process*)current->data)->arriveTime;
+    }
+    
+    return(overlay);
+}
+
   //								 //
  // Compare functions for sorting   //
 //								   //
 
+// values an algorithm may change, read from the overlay if the run has one
+#define BURST_LEFT(process, overlay)  ((overlay) ? ((const Overlay*)(overlay))[(process)->index].burstLeft : (process)->burst)
+#define ARRIVE_TIME(process, overlay) ((overlay) ? ((const Overlay*)(overlay))[(process)->index].arriveTime : (process)->arriveTime)
+
 // compare by time of arrival, if same time by pid
-gint compareArrival(gconstpointer *a, gconstpointer *b){
+gint compareArrival(gconstpointer a, gconstpointer b, gpointer overlay){
 	
-	int compare = ((Process*)a)->arriveTime - ((Process*)b)->arriveTime;
+	int compare = COMPARE(ARRIVE_TIME((const Process*)a, overlay), ARRIVE_TIME((const Process*)b, overlay));
 	
 	if(compare != 0) 		// if arriveTimes are different return result
 		return compare;
 	
 	else					// if not, compare by pid and return
-		return ((Process*)a)->pid - ((Process*)b)->pid;
+		return COMPARE(((const Process*)a)->pid, ((const Process*)b)->pid);
 }
 
 // compare by burst lenght, if same time by pid
-gint compareBurst(gconstpointer *a, gconstpointer *b){
+gint compareBurst(gconstpointer a, gconstpointer b, gpointer overlay){
 	
-	int compare = ((Process*)a)->burstLeft - ((Process*)b)->burstLeft;
+	int compare = COMPARE(BURST_LEFT((const Process*)a, overlay), BURST_LEFT((const Process*)b, overlay));
 	
 	if(compare != 0)
 		return compare; 	// if bursts are diferent return result
 		
 	//if burst is the same, sort by arriveTime
-	compare = ((Process*)a)->arriveTime - ((Process*)b)->arriveTime;
+	compare = COMPARE(((const Process*)a)->arriveTime, ((const Process*)b)->arriveTime);
 	
 	if(compare != 0 )
 		return compare;
 
 	// if arriveTime is the same, sort by ID
 	else
-		return ((Process*)a)->pid - ((Process*)b)->pid;
+		return COMPARE(((const Process*)a)->pid, ((const Process*)b)->pid);
 }
 
 // compare by priority, if same time by pid
-gint comparePriority(gconstpointer *a, gconstpointer *b){
+gint comparePriority(gconstpointer a, gconstpointer b, gpointer overlay){
 	
-	int compare = ((Process*)a)->priority - ((Process*)b)->priority;
+	int compare = COMPARE(((const Process*)a)->priority, ((const Process*)b)->priority);
+	
+	(void)overlay;		//priorities and true arrivals never change, the overlay is not needed
 	
 	if(compare != 0)
 		return compare;		// if priorities are diferent return result
 			
 	//if priority is the same, sort by arriveTime
-	compare = ((Process*)a)->arriveTime - ((Process*)b)->arriveTime;
+	compare = COMPARE(((const Process*)a)->arriveTime, ((const Process*)b)->arriveTime);
 	
 	if(compare != 0 )
 		return compare;
 	
 	// if arriveTime is the same, sort by ID
 	else
-		return ((Process*)a)->pid - ((Process*)b)->pid;
+		return COMPARE(((const Process*)a)->pid, ((const Process*)b)->pid);
+}
+
+
+// compare two entries of the order of a run with one of the functions above
+static gint compareEntries(gconstpointer a, gconstpointer b, gpointer sortBy){
+	
+	return ((SortBy*)sortBy)->compare(*(const Process**)a, *(const Process**)b, (gpointer)((SortBy*)sortBy)->overlay);
+}
+
+
+  //								 //
+ // Order of a run				    //
+//								   //
+
+// Each run keeps the processes it still has to finish in an array of pointers to the shared ones,
+// in the order it looks at them. It is the only part of the list a run changes
+
+// Fill the order of a run, the processes of a run still to finish, with the list in its order. Returns how many there are
+static int ListOrder(GList *list, const Process **order)
+{
+    int count = 0;
+    
+    for (; list; list = list->next)
+        order[count++] = list->data;
+    
+    return(count);
+}
+
+// Sort the order of a run, equal processes keep their order like g_list_sort does
+static void SortOrder(const Process **order, int count, GCompareDataFunc compare, const Overlay *overlay)
+{
+    SortBy sortBy = { compare, overlay };
+    
+    g_qsort_with_data(order, count, sizeof(const Process*), compareEntries, &sortBy);
+}
+
+// Remove the process at position from the order of a run, the others keep their order
+static void RemoveAt(const Process **order, int *count, int position)
+{
+    (*count)--;
+    memmove(&order[position], &order[position + 1], (*count - position) * sizeof(const Process*));
+}
+
+// Insert the process before the first one that does not go before it, like g_list_insert_sorted does
+static void InsertSorted(const Process **order, int *count, const Process *process, GCompareDataFunc compare, const Overlay *overlay)
+{
+    int position = 0;
+    
+    while (position < *count && compare(process, order[position], (gpointer)overlay) > 0)
+        position++;
+    
+    memmove(&order[position + 1], &order[position], (*count - position) * sizeof(const Process*));
+    order[position] = process;
+    (*count)++;
 }
 
 
@@ -137,42 +263,101 @@ gint comparePriority(gconstpointer *a, gconstpointer *b){
  
 
 // Creates a process and appends it to the list, returns new list 
-GList* CreateProcess(GList *processList, int pid, int arriveTime, int burst, int priority){
+GList* CreateProcess(GList *processList, int pid, int64_t arriveTime, int64_t burst, int priority){
  	
- 	Process *process = newProcess(pid, arriveTime, burst, priority, burst);
+ 	Process *process = newProcess(pid, arriveTime, burst, priority, g_list_length(processList));
  	
  	processList  = g_list_append(processList, process);
  			
  	return processList;
 }
 
-// Create a copy of the list given
-//SRC  is the data to copy
-//data is something to pass to the function, can be nullable
-GCopyFunc copyList(gconstpointer src, gpointer data){
-	
-    Process *process = malloc(sizeof(Process)); 
 
-    process->pid = ((Process*)src)->pid;
-    process->arriveTime = ((Process*)src)->arriveTime;
-    process->burst = ((Process*)src)->burst;
-    process->priority = ((Process*)src)->priority;
-    
-    process->burstLeft = ((Process*)src)->burstLeft;
-    process->firstArriveTime = ((Process*)src)->firstArriveTime;
-    
-    return (gconstpointer)process;
+//Sorts a list by arrivalTime using compareArrival, the processes are numbered in their new order.
+//Only used while loading, the processes are not changed after it
+static GList* SortProcessList(GList* list){
+	
+	GList *current;
+	int index = 0;
+	
+	list = g_list_sort_with_data(list, (GCompareDataFunc)compareArrival, NULL);
+	
+	for (current = list; current; current = current->next)
+		((Process*)current->data)->index = index++;
+	
+	return list;
 }
 
-
-//Sorts a list by arrivalTime using compareArrival
-//Function currently NOT used
-GList* SortProcessList(GList* list){
+//Reads the quantum of an input file and then its processes, four numbers each: pid, arrival time, burst and priority.
+//The list is sorted by arrival and then pid, and never changes afterwards. Returns EXIT_FAILURE and the reason in
+//error if the file can not be used
+int LoadProcessList(FILE *fp, int64_t *quantum, GList **list, char **error){
 	
+	int64_t parameters[NUMVAL];
+	int64_t totalBurst = 0, lastArrival = 0;
+	GList *loaded = NULL;
+	int count = 0, status, i;
 	
-	list = g_list_sort(list, (GCompareFunc)compareArrival);
+	*error = NULL;
+	status = GetInt64(fp, quantum);
 	
-	return list;
+	if(status == EOF)
+		*error = "Quantum not found";
+	
+	else if(status == EXIT_FAILURE)
+		*error = "a number does not fit in 64 bits";
+	
+	else if(*quantum < 1)
+		*error = "the quantum has to be positive";
+	
+	while(!*error){
+		
+		for(i = 0; i < NUMVAL && status == EXIT_SUCCESS; i++)
+			status = GetInt64(fp, &parameters[i]);
+		
+		//the file ended, numbers left over after the last process are ignored
+		if(status == EOF)
+			break;
+		
+		if(status == EXIT_FAILURE)
+			*error = "a number does not fit in 64 bits";
+		
+		//pid and priority are int, do not truncate them
+		else if(parameters[0] < INT_MIN || parameters[0] > INT_MAX || parameters[3] < INT_MIN || parameters[3] > INT_MAX)
+			*error = "pid or priority out of range";
+		
+		else if(parameters[1] < 0)
+			*error = "arrival times can not be negative";
+		
+		//a process that never runs out of burst would never let Preemptive end
+		else if(parameters[2] < 1)
+			*error = "every burst has to be positive";
+		
+		else if(parameters[2] > INT64_MAX - totalBurst)
+			*error = "the times of the file do not fit in 64 bits";
+		
+		else{
+			totalBurst += parameters[2];
+			lastArrival = parameters[1] > lastArrival ? parameters[1] : lastArrival;
+			count++;
+			
+			loaded = g_list_prepend(loaded, newProcess((int)parameters[0], parameters[1], parameters[2], (int)parameters[3], 0));
+		}
+	}
+	
+	//no process finishes after the last arrival plus every burst, so that time and the sum of
+	//the waits, each shorter than it, have to fit in 64 bits for the algorithms to add them
+	if(!*error && (lastArrival > INT64_MAX - totalBurst || (count && lastArrival + totalBurst > INT64_MAX / count)))
+		*error = "the times of the file do not fit in 64 bits";
+	
+	if(*error){
+		DestroyList(loaded);
+		return (EXIT_FAILURE);
+	}
+	
+	*list = SortProcessList(g_list_reverse(loaded));
+	
+	return (EXIT_SUCCESS);
 }
 
 //Prints the list 
@@ -183,7 +368,7 @@ void PrintProcessList(GList* processList){
 	
 	for (current = processList; current; current = current->next) {  // stops until current is NULL 
 		
-	  	printf("%d %d %d %d\n", ((Process*)current->data)->pid, ((Process*)current->data)->arriveTime, 
+	  	printf("%d %" PRId64 " %" PRId64 " %d\n", ((Process*)current->data)->pid, ((Process*)current->data)->arriveTime, 
 		  						((Process*)current->data)->burst, ((Process*)current->data)->priority);
 								
 		  
@@ -191,6 +376,23 @@ void PrintProcessList(GList* processList){
 	}
 }
 
+//Copies the fields of every process into the arrays, in the order of their completion times
+void ProcessFields(GList* processList, int *pid, int64_t *arriveTime, int64_t *burst, int *priority){
+	
+	GList *current;
+	Process *process;
+	
+	for (current = processList; current; current = current->next) {
+		
+		process = current->data;
+		
+		pid[process->index] = process->pid;
+		arriveTime[process->index] = process->arriveTime;
+		burst[process->index] = process->burst;
+		priority[process->index] = process->priority;
+	}
+}
+
 // Dealocate memory, function needs to be called after handling the list and before terminating
 void DestroyList(GList *processList){
 	
@@ -201,6 +403,382 @@ void DestroyList(GList *processList){
 }
 
 
+  //								 //
+ // CHECKPOINT AND RESUME		    //
+//								   //
+
+// Every algorithm call in main is a stage, a checkpoint file holds the result of the stages already
+// finished and, if a Preemptive or RoundRobin stage was running, its list, overlay and counters.
+// The file is a raw dump of the structures below, so it is only meant to be read back on the same machine.
+// Everything read back is checked before use, a checkpoint that fails a check is ignored
+
+#define CHECKPOINT_MAGIC 0x34504B4348444353LL	/* "SCHDCKP4" */
+#define CHECKPOINT_STEPS 0x3FF						/* steps between looks at the clock, keeps the check cheap */
+
+#define STAGE_PREEMPTIVE 1
+#define STAGE_ROUNDROBIN 2
+
+typedef struct {
+	
+	int64_t magic;
+	uint64_t workload;			/* hash of the input list, a checkpoint of another input is ignored */
+	int64_t completed;			/* number of stages finished, their results follow the header */
+	
+	int64_t algorithm;			/* STAGE_PREEMPTIVE, STAGE_ROUNDROBIN or 0 if no stage was running */
+	char criteria[16];			/* criteria of the Preemptive stage */
+	int64_t quantum;			/* quantum of the RoundRobin stage */
+	int64_t timePassed;
+	int64_t totalWaitTime;
+	int64_t size;
+	int64_t count;				/* number of processes still in the list, they follow the results */
+	uint64_t checksum;			/* hash of the results and processes that follow */
+	
+}CheckpointHeader;
+
+typedef struct {
+	
+	int64_t totalWaitTime;
+	int64_t size;
+	
+}StageResult;
+
+// A process still in the list of the running stage, in list order
+typedef struct {
+	
+	int64_t index;
+	int64_t burstLeft;
+	int64_t arriveTime;
+	
+}CheckpointProcess;
+
+static const char *checkpointPath = NULL;		/* NULL when checkpoints are disabled */
+static time_t checkpointSeconds;
+static time_t nextCheckpoint;
+static unsigned int checkpointSteps;
+static uint64_t workloadHash;
+static int checkpointStages;					/* stages main runs */
+
+static int stage;								/* stages started in this run */
+static StageResult *results;					/* results of the finished stages */
+static int completed;
+
+static CheckpointHeader *resume;				/* checkpoint being resumed, NULL if none */
+static CheckpointProcess *resumeProcesses;
+
+#define FNV_OFFSET 14695981039346656037ULL
+
+// FNV-1a hash of some bytes, continuing from a previous hash
+static uint64_t Hash(uint64_t hash, const void *data, size_t length){
+	
+	const unsigned char *byte = data;
+	size_t i;
+	
+	for(i = 0; i < length; i++){
+		hash ^= byte[i];
+		hash *= 1099511628211ULL;
+	}
+	
+	return hash;
+}
+
+// Hash of the fields read from the input file
+static uint64_t HashProcessList(GList *list){
+	
+	uint64_t hash = FNV_OFFSET;
+	int64_t fields[4];
+	GList *current;
+	
+	for(current = list; current; current = current->next){
+		
+		fields[0] = ((Process*)current->data)->pid;
+		fields[1] = ((Process*)current->data)->arriveTime;
+		fields[2] = ((Process*)current->data)->burst;
+		fields[3] = ((Process*)current->data)->priority;
+		
+		hash = Hash(hash, fields, sizeof(fields));
+	}
+	
+	return hash;
+}
+
+// Writes the checkpoint to a temporary file and renames it, so a crash while writing keeps the previous one
+static void SaveCheckpoint(int algorithm, char *criteria, int64_t quantum, const Process **order, int count, const Overlay *overlay, int64_t timePassed, int64_t totalWaitTime, int size){
+	
+	CheckpointHeader header;
+	CheckpointProcess *processes;
+	char temporary[FILENAME_MAX];
+	FILE *fp;
+	int64_t i;
+	
+	memset(&header, 0, sizeof(header));
+	
+	header.magic = CHECKPOINT_MAGIC;
+	header.workload = workloadHash;
+	header.completed = completed;
+	header.algorithm = algorithm;
+	if(criteria)
+		strncpy(header.criteria, criteria, sizeof(header.criteria) - 1);
+	header.quantum = quantum;
+	header.timePassed = timePassed;
+	header.totalWaitTime = totalWaitTime;
+	header.size = size;
+	header.count = count;
+	
+	processes = g_new(CheckpointProcess, header.count);
+	
+	for(i = 0; i < count; i++){
+		
+		processes[i].index = order[i]->index;
+		processes[i].burstLeft = overlay[processes[i].index].burstLeft;
+		processes[i].arriveTime = overlay[processes[i].index].arriveTime;
+	}
+	
+	header.checksum = Hash(Hash(FNV_OFFSET, results, completed * sizeof(StageResult)), processes, header.count * sizeof(CheckpointProcess));
+	
+	snprintf(temporary, sizeof(temporary), "%s.tmp", checkpointPath);
+	
+	fp = fopen(temporary, "wb");
+	if(!fp){
+		WarningMsg("SaveCheckpoint", "could not create the checkpoint file, the run goes on without it");
+		g_free(processes);
+		return;
+	}
+	
+	//g_new gives NULL for no elements, which fwrite and fread do not take
+	fwrite(&header, sizeof(header), 1, fp);
+	if(completed)
+		fwrite(results, sizeof(StageResult), completed, fp);
+	if(header.count)
+		fwrite(processes, sizeof(CheckpointProcess), header.count, fp);
+	
+	g_free(processes);
+	
+	if(fflush(fp) || fsync(fileno(fp)) || ferror(fp)){
+		WarningMsg("SaveCheckpoint", "could not write the checkpoint file, the run goes on without it");
+		fclose(fp);
+		remove(temporary);
+		return;
+	}
+	
+	fclose(fp);
+	rename(temporary, checkpointPath);
+	
+	nextCheckpoint = time(NULL) + checkpointSeconds;
+}
+
+// Returns 1 when enough wall clock time passed since the last checkpoint, only looks at the clock every CHECKPOINT_STEPS calls
+static int CheckpointDue(void){
+	
+	if(++checkpointSteps & CHECKPOINT_STEPS)
+		return 0;
+	
+	return time(NULL) >= nextCheckpoint;
+}
+
+// Returns 1 if the results and processes read from a checkpoint are consistent with the input list of size
+// processes: every index in range and only once, every burst left positive and no larger than its burst
+static int ValidCheckpoint(const CheckpointHeader *header, const StageResult *stageResults, const CheckpointProcess *processes, GList *list, int size){
+	
+	Process **byIndex;
+	char *seen;
+	GList *current;
+	int64_t i, index;
+	int valid = 1;
+	
+	if(Hash(Hash(FNV_OFFSET, stageResults, header->completed * sizeof(StageResult)), processes, header->count * sizeof(CheckpointProcess)) != header->checksum)
+		return 0;
+	
+	for(i = 0; i < header->completed; i++)
+		if(stageResults[i].size != size)
+			return 0;
+	
+	byIndex = g_new(Process*, size);
+	seen = g_new0(char, size);
+	
+	for(current = list; current; current = current->next)
+		byIndex[((Process*)current->data)->index] = current->data;
+	
+	for(i = 0; valid && i < header->count; i++){
+		
+		index = processes[i].index;
+		
+		valid = index >= 0 && index < size && !seen[index] &&
+				processes[i].burstLeft > 0 && processes[i].burstLeft <= byIndex[index]->burst;
+		
+		if(valid)
+			seen[index] = 1;
+	}
+	
+	g_free(byIndex);
+	g_free(seen);
+	
+	return valid;
+}
+
+// Reads a checkpoint left by a previous run of the same input, returns 0 if there is none or it does not pass the checks
+static int LoadCheckpoint(GList *list){
+	
+	CheckpointHeader header;
+	StageResult *stageResults;
+	CheckpointProcess *processes;
+	FILE *fp = fopen(checkpointPath, "rb");
+	int size = g_list_length(list);
+	
+	if(!fp)
+		return 0;
+	
+	if(fread(&header, sizeof(header), 1, fp) != 1 || header.magic != CHECKPOINT_MAGIC || header.workload != workloadHash){
+		WarningMsg("LoadCheckpoint", "checkpoint does not belong to this input, starting from the beginning");
+		fclose(fp);
+		return 0;
+	}
+	
+	//the counts decide how much is read, check them before allocating anything
+	if(header.completed < 0 || header.completed > checkpointStages || header.count < 0 || header.count > size ||
+	   (header.algorithm == 0 && header.count != 0) ||
+	   (header.algorithm != 0 && (header.completed == checkpointStages || header.size != size ||
+	   (header.algorithm != STAGE_PREEMPTIVE && header.algorithm != STAGE_ROUNDROBIN)))){
+		
+		WarningMsg("LoadCheckpoint", "checkpoint is corrupted, starting from the beginning");
+		fclose(fp);
+		return 0;
+	}
+	
+	stageResults = g_new(StageResult, header.completed);
+	processes = g_new(CheckpointProcess, header.count);
+	
+	if((header.completed && fread(stageResults, sizeof(StageResult), header.completed, fp) != (size_t)header.completed) ||
+	   (header.count && fread(processes, sizeof(CheckpointProcess), header.count, fp) != (size_t)header.count) ||
+	   !ValidCheckpoint(&header, stageResults, processes, list, size)){
+		
+		WarningMsg("LoadCheckpoint", "checkpoint is truncated or corrupted, starting from the beginning");
+		g_free(stageResults);
+		g_free(processes);
+		fclose(fp);
+		return 0;
+	}
+	
+	fclose(fp);
+	
+	resume = g_new(CheckpointHeader, 1);
+	*resume = header;
+	
+	g_free(results);
+	results = stageResults;
+	resumeProcesses = processes;
+	completed = header.completed;
+	
+	return 1;
+}
+
+// Enables checkpoints every given number of seconds for the list given, main runs the given number of stages.
+// Resumes from path if it already exists
+void SetCheckpoint(GList *list, const char *path, int seconds, int stages){
+	
+	checkpointPath = path;
+	checkpointSeconds = seconds;
+	checkpointStages = stages;
+	nextCheckpoint = time(NULL) + seconds;
+	workloadHash = HashProcessList(list);
+	
+	LoadCheckpoint(list);
+}
+
+// Removes the checkpoint file, called once every stage finished
+void ClearCheckpoint(void){
+	
+	if(checkpointPath)
+		remove(checkpointPath);
+	
+	g_free(results);
+	g_free(resume);
+	g_free(resumeProcesses);
+	
+	results = NULL;
+	resume = NULL;
+	resumeProcesses = NULL;
+	completed = 0;
+	stage = 0;
+}
+
+// Starts a stage, returns 1 if its result is already in the checkpoint being resumed
+static int BeginStage(int64_t *totalWaitTime, int *size){
+	
+	if(!checkpointPath)
+		return 0;
+	
+	stage++;
+	
+	if(stage > completed)
+		return 0;
+	
+	*totalWaitTime = results[stage - 1].totalWaitTime;
+	*size = results[stage - 1].size;
+	
+	return 1;
+}
+
+// Restores the order and overlay of the stage that was running when the checkpoint was taken and returns how many
+// processes its order has, -1 if it is another stage. The order holds processes of the input list of size processes
+static int ResumeStage(int algorithm, char *criteria, int64_t quantum, GList *input, int size, const Process **order, Overlay *overlay, int64_t *timePassed, int64_t *totalWaitTime){
+	
+	const Process **processes;
+	GList *current;
+	int64_t i, index;
+	int count;
+	
+	if(!resume || resume->completed != stage - 1 || resume->algorithm != algorithm ||
+	   strncmp(resume->criteria, criteria ? criteria : "", sizeof(resume->criteria) - 1) || resume->quantum != quantum || resume->size != size)
+		return -1;
+	
+	//find every process of the input by its index
+	processes = g_new(const Process*, size);
+	
+	for(current = input; current; current = current->next)
+		processes[((const Process*)current->data)->index] = current->data;
+	
+	for(i = 0; i < resume->count; i++){
+		
+		index = resumeProcesses[i].index;
+		
+		overlay[index].burstLeft = resumeProcesses[i].burstLeft;
+		overlay[index].arriveTime = resumeProcesses[i].arriveTime;
+		
+		order[i] = processes[index];
+	}
+	
+	g_free(processes);
+	
+	count = resume->count;
+	
+	*timePassed = resume->timePassed;
+	*totalWaitTime = resume->totalWaitTime;
+	
+	g_free(resume);
+	g_free(resumeProcesses);
+	resume = NULL;
+	resumeProcesses = NULL;
+	
+	return count;
+}
+
+// Finishes a stage: records its result for later checkpoints and returns the average wait time
+static double EndStage(int64_t totalWaitTime, int size){
+	
+	if(checkpointPath && stage > completed){
+		
+		results = g_renew(StageResult, results, completed + 1);
+		results[completed].totalWaitTime = totalWaitTime;
+		results[completed].size = size;
+		completed++;
+		
+		SaveCheckpoint(0, NULL, 0, NULL, 0, NULL, 0, 0, 0);
+	}
+	
+	return (double)totalWaitTime / size;	//average wait time of algorithm
+}
+
+
   //								 //
  // DISPATCHER ALGORITHM FUNCTIONS  //
 //								   //
@@ -208,121 +786,188 @@ void DestroyList(GList *processList){
 
 //This function is used for the priority and SJF algorithms
 //It needs the processList header and a string to diferentiate betweeen the diferent algorithms
-void Preemptive(GList* list, char *criteria){
+//If completion is not NULL it receives the time each process finished, in the order of the list
+double Preemptive(GList* list, char *criteria, int64_t *completion){
 	
-	//for traversing the list
-	GList* current;
+	//for traversing the order
+	int current;
 	
-	GList* copy = g_list_copy_deep(list, (GCopyFunc)copyList, NULL);
+	//processes still running in the order they are looked at, and how many there are
+	const Process** order;
+	int count;
 	
 	//temporarily store a Process
-	Process* temp;
+	const Process* temp;
 	
 	// used to keep track of the waitTime of all the processes
-	float totalWaitTime = 0;
+	int64_t totalWaitTime = 0;
 	
 	//measures the total time passed during the whole function
-	int timePassed = 0;
+	int64_t timePassed = 0;
+	
+	//size of the process list
+	int size;
 	
-	//get the size of the process list
-	int size = g_list_length(copy);
+	//burst left of each process, by index, the processes themselves are never changed
+	Overlay* overlay;
 	
 	//used to keep the processor idle until a process arrives
 	int found;
 	
-	//Sort the list depending on the chosen criteria
-	if(!strcmp(criteria, "priority"))
-		copy = g_list_sort(copy, (GCompareFunc)comparePriority);
+	//earliest arrival among the processes that have not arrived yet
+	int64_t nextArrival;
+	
+	//if the result is already in the checkpoint there is nothing to simulate
+	if(BeginStage(&totalWaitTime, &size))
+		return EndStage(totalWaitTime, size);
+	
+	//continue from the checkpoint if it was taken in this stage, otherwise start from the order of the list
+	size = g_list_length(list);
+	
+	overlay = newOverlay(list, size);
+	order = g_new(const Process*, size);
+	
+	count = ResumeStage(STAGE_PREEMPTIVE, criteria, 0, list, size, order, overlay, &timePassed, &totalWaitTime);
+	
+	if(count < 0){
+		
+		count = ListOrder(list, order);
+		
+		//Sort the order depending on the chosen criteria
+		if(!strcmp(criteria, "priority"))
+			SortOrder(order, count, comparePriority, NULL);
+	}
 	
 	//while there are processes to process				
-	while(copy){
+	while(count){
+		
+		if(checkpointPath && CheckpointDue())
+			SaveCheckpoint(STAGE_PREEMPTIVE, criteria, 0, order, count, overlay, timePassed, totalWaitTime, size);
 			
 		//restart found, at the beginning we dont know if there are any proceses waiting
 		found = 0;
+		nextArrival = INT64_MAX;
 		
-		//Sort the list depending on the chosen criteria, since processes bursts change every cycle we need to re-sort
+		//Sort the order depending on the chosen criteria, since processes bursts change every cycle we need to re-sort
 		if(!strcmp(criteria, "burst"))
-			copy = g_list_sort(copy, (GCompareFunc)compareBurst);
+			SortOrder(order, count, compareBurst, overlay);
 				
-		//traverse the list to find the next process
-		for(current = copy; current; current = current->next){
+		//traverse the order to find the next process
+		for(current = 0; current < count; current++){
 			
-			if(((Process*)current->data)->arriveTime <= timePassed){ 			//use the first process of the list that has arrived
+			if(order[current]->arriveTime <= timePassed){ 						//use the first process of the order that has arrived
 																												
 				found = 1;														//if process is found stop searching
 				break;
 			}	
+			
+			if(order[current]->arriveTime < nextArrival)						//remember the earliest arrival in case the processor is idle
+				nextArrival = order[current]->arriveTime;
 		}
 		
-		//everycycle increase by one
-		timePassed ++;
-		
 		if(found){
 			
-			((Process*)current->data)->burstLeft -= 1; 							//reduce the burst by one
+			//everycycle increase by one
+			timePassed ++;
+			
+			overlay[order[current]->index].burstLeft -= 1; 						//reduce the burst by one
 						
-			if(((Process*)current->data)->burstLeft == 0){						//if process is done
+			if(overlay[order[current]->index].burstLeft == 0){					//if process is done
 				
-				int waitTime = timePassed - ((Process*)current->data)->burst - ((Process*)current->data)->arriveTime; 	//get the wait time to the process
+				int64_t waitTime = timePassed - order[current]->burst - order[current]->arriveTime; 	//get the wait time to the process
 				
-				//printf("waitime of %d is %d\n", ((Process*)current->data)->pid, waitTime );
+				//printf("waitime of %d is %d\n", order[current]->pid, waitTime );
 				
 				totalWaitTime += waitTime;										//add the process waitTime to the total waitTime
 				
-				copy = g_list_remove(copy, ((Process*)current->data));			// remove process from the list 
+				if(completion)
+					completion[order[current]->index] = timePassed;				//record when the process finished
+				
+				RemoveAt(order, &count, current);								// remove process from the order 
 			}
 			
-			/*else{  	//send the process to the end of the list
+			/*else{  	//send the process to the end of the order
 				
-				temp = ((Process*)current->data);								//store a process temporarily
+				temp = order[current];											//store a process temporarily
 					
-				copy = g_list_remove(copy, ((Process*)current->data));			// remove process from the list 
+				RemoveAt(order, &count, current);								// remove process from the order 
 				
-				copy = g_list_append(copy, temp);								//re-add the process at the end of the list	
+				order[count++] = temp;											//re-add the process at the end of the order	
 			}	*/
 		}
+		
+		else
+			timePassed = nextArrival;											//processor is idle, jump straight to the next arrival
 	}
 							
-	totalWaitTime /= size; 	//calculate average wait time of algorithm
-	
-	g_list_free(copy); 		// deallocate memory of the copy list
+	g_free(order); 			// deallocate memory of the order
+	g_free(overlay);
 
-	printf("%f\n\n", totalWaitTime);	
+	return EndStage(totalWaitTime, size);
 }
 
-void RoundRobin(GList* list, int quantum){
+//If completion is not NULL it receives the time each process finished, in the order of the list
+double RoundRobin(GList* list, int64_t quantum, int64_t *completion){
 	
-	//for traversing the list
-	GList* current;
+	//for traversing the order
+	int current;
 	
-	GList* copy = g_list_copy_deep(list, (GCopyFunc)copyList, NULL);
+	//processes still running in the order they are looked at, and how many there are
+	const Process** order;
+	int count;
 	
 	//temporarily store a Process
-	Process* temp;
+	const Process* temp;
 	
 	// used to keep track of the waitTime of all the processes
-	float totalWaitTime = 0;
+	int64_t totalWaitTime = 0;
 	
 	//measures the total time passed during the whole function
-	int timePassed = 0;
+	int64_t timePassed = 0;
 	
-	//get the size of the process list
-	int size = g_list_length(copy);
+	//size of the process list
+	int size;
+	
+	//burst left and turn arrival of each process, by index, the processes themselves are never changed
+	Overlay* overlay;
 	
 	//found used to keep the processor idle until a process arrives
-	int found, i;
-
-	copy = g_list_sort(copy, (GCompareFunc)compareArrival);
-							
-	while(copy){
+	int found;
+	
+	//time the process runs in this turn, the quantum or less if it finishes before
+	int64_t slice;
+	
+	//if the result is already in the checkpoint there is nothing to simulate
+	if(BeginStage(&totalWaitTime, &size))
+		return EndStage(totalWaitTime, size);
+	
+	//continue from the checkpoint if it was taken in this stage, otherwise start from the order of the list
+	size = g_list_length(list);
+	
+	overlay = newOverlay(list, size);
+	order = g_new(const Process*, size);
+	
+	count = ResumeStage(STAGE_ROUNDROBIN, NULL, quantum, list, size, order, overlay, &timePassed, &totalWaitTime);
+	
+	if(count < 0){
+		
+		count = ListOrder(list, order);
+		
+		SortOrder(order, count, compareArrival, overlay);
+	}
+						
+	while(count){
+		
+		if(checkpointPath && CheckpointDue())
+			SaveCheckpoint(STAGE_ROUNDROBIN, NULL, quantum, order, count, overlay, timePassed, totalWaitTime, size);
 					
 		//restart found, at the beginning we dont know if there are any proceses waiting
 		found = 0;
 			
-		//traverse the list to find the next process
-		for(current = copy; current; current = current->next){
+		//traverse the order to find the next process
+		for(current = 0; current < count; current++){
 			
-			if(((Process*)current->data)->arriveTime <= timePassed ){ 			//use the first process of the list that has arrived
+			if(overlay[order[current]->index].arriveTime <= timePassed ){ 			//use the first process of the order that has arrived
 																														
 				found = 1;														//if process is found stop searching
 				break;
@@ -331,153 +976,233 @@ void RoundRobin(GList* list, int quantum){
 		
 		if(found){
 						
-			for(i = 0; i < quantum; i++){
-				
-				timePassed ++; 													// increase time passed by the quantum
-				((Process*)current->data)->burstLeft -= 1; 						//reduce the burst by the quantum
-				
-				if(((Process*)current->data)->burstLeft == 0)
-					break;														// make sure that the process stops when it reaches 0
-			}
+			slice = quantum;
 			
-			if(((Process*)current->data)->burstLeft == 0){
+			if(overlay[order[current]->index].burstLeft < slice)
+				slice = overlay[order[current]->index].burstLeft;					// make sure that the process stops when it reaches 0
+			
+			timePassed += slice; 												// increase time passed by the quantum
+			overlay[order[current]->index].burstLeft -= slice; 					//reduce the burst by the quantum
+			
+			if(overlay[order[current]->index].burstLeft == 0){
 				
-				int waitTime = timePassed - ((Process*)current->data)->burst - ((Process*)current->data)->firstArriveTime; //get the wait time to the process
+				int64_t waitTime = timePassed - order[current]->burst - order[current]->arriveTime; //get the wait time to the process
 				
 				totalWaitTime += waitTime;										//add the process waitTime to the total waitTime
 				
-				copy = g_list_remove(copy, ((Process*)current->data));			// remove process from the list 
+				if(completion)
+					completion[order[current]->index] = timePassed;				//record when the process finished
+				
+				RemoveAt(order, &count, current);								// remove process from the order 
 									
 			}	
-			else{  	//send the process to the end of the list
+			else{  	//send the process to the end of the order
 				
-				temp = ((Process*)current->data);										//store a process temporarily
+				temp = order[current];													//store a process temporarily
 				
-				temp->arriveTime = timePassed;											// Update the arriveTime of the process
+				overlay[temp->index].arriveTime = timePassed;							// Update the arriveTime of the process
 					
-				copy = g_list_remove(copy, ((Process*)current->data));					// remove process from the list 
+				RemoveAt(order, &count, current);										// remove process from the order 
 					
-				copy = g_list_insert_sorted(copy, temp, (GCompareFunc)compareArrival); 	//re-add the process at its new position
+				InsertSorted(order, &count, temp, compareArrival, overlay); 			//re-add the process at its new position
 			}
 		}
 		
 		else
-			timePassed++;														//if theres no process in the queue, increase time by 1
+			timePassed = overlay[order[0]->index].arriveTime;					//if theres no process in the queue, jump to the next arrival (order is sorted by arrival)
 	}
 		
 	
-	totalWaitTime /= size;		//calculate average wait time of algorithm
-	
-	g_list_free(copy); 			// deallocate memory of the copy list
+	g_free(order); 				// deallocate memory of the order
+	g_free(overlay);
 
-	printf("%f\n\n", totalWaitTime);	
+	return EndStage(totalWaitTime, size);
 }
 
-void FirstCome(GList* list){
+//If completion is not NULL it receives the time each process finished, in the order of the list
+double FirstCome(GList* list, int64_t *completion){
 		
-	GList* copy = g_list_copy_deep(list, (GCopyFunc)copyList, NULL);
+	//for traversing the order
+	int current;
+	
+	//processes to run in the order they run, and how many there are
+	const Process** order;
+	int count;
 	
 	// used to keep track of the waitTime of all the processes
-	float totalWaitTime = 0;
+	int64_t totalWaitTime = 0;
 	
 	//measures the total time passed during the whole function
-	int timePassed = 0;
+	int64_t timePassed = 0;
 	
-	//get the size of the process list
-	int size = g_list_length(copy);
-			
-	//sort the list one time only
-	copy = g_list_sort(copy, (GCompareFunc)compareArrival);
+	//size of the process list
+	int size;
+	
+	//if the result is already in the checkpoint there is nothing to simulate
+	if(BeginStage(&totalWaitTime, &size))
+		return EndStage(totalWaitTime, size);
+	
+	size = g_list_length(list);
+	
+	order = g_new(const Process*, size);
 	
+	count = ListOrder(list, order);
+			
+	//sort the order one time only
+	SortOrder(order, count, compareArrival, NULL);
 	
-	while(copy){
+	//the first process of the order is always the next one, walk it instead of removing from the front
+	for(current = 0; current < count; ){
 											
-		if(((Process*)copy->data)->arriveTime > timePassed){ 			//only use the first process of the list that HAS arrived
+		if(order[current]->arriveTime > timePassed){ 					//only use the first process of the order that HAS arrived
 																												
-			timePassed++; 												// if a process has not arrived, increase the time and recheck
+			timePassed = order[current]->arriveTime;					// if a process has not arrived, jump to its arrival and recheck
 		}
 		
 		else{
 			
-			timePassed += ((Process*)copy->data)->burst;  				// increase timePassed by burst amount
+			timePassed += order[current]->burst;  						// increase timePassed by burst amount
 						
-			int waitTime = timePassed - ((Process*)copy->data)->burst - ((Process*)copy->data)->arriveTime; //get the wait time to the process
+			int64_t waitTime = timePassed - order[current]->burst - order[current]->arriveTime; //get the wait time to the process
 				
 			totalWaitTime += waitTime;									//add the process waitTime to the total waitTime
+			
+			if(completion)
+				completion[order[current]->index] = timePassed;			//record when the process finished
 				
-			copy = g_list_remove(copy, ((Process*)copy->data));			// remove process from the list 
+			current++;													// move on to the next process 
 		}
 	}
 		
 	
-	totalWaitTime /= size;	//calculate average wait time of algorithm
-	
-	g_list_free(copy); 		// deallocate memory of the copy list
+	g_free(order); 			// deallocate memory of the order
 
-	printf("%f\n\n", totalWaitTime);	
+	return EndStage(totalWaitTime, size);
 }
 
 
 //This function is used for the priority and SJF  NonPreemptive algorithms
 //It needs the processList header and a string to diferentiate betweeen the diferent algorithms
-void NonPreemptive(GList* list, char *criteria){
+//If completion is not NULL it receives the time each process finished, in the order of the list
+double NonPreemptive(GList* list, char *criteria, int64_t *completion){
 	
-	//for traversing the list
-	GList* current;
+	//for traversing the order
+	int current;
 	
-	GList* copy = g_list_copy_deep(list, (GCopyFunc)copyList, NULL);
+	//processes still to run in the order they are looked at, and how many there are
+	const Process** order;
+	int count;
 	
 	// used to keep track of the waitTime of all the processes
-	float totalWaitTime = 0;
+	int64_t totalWaitTime = 0;
 	
 	//measures the total time passed during the whole function
-	int timePassed = 0 , found;
+	int64_t timePassed = 0;
+	
+	//used to keep the processor idle until a process arrives
+	int found;
+	
+	//earliest arrival among the processes that have not arrived yet
+	int64_t nextArrival;
+	
+	//size of the process list
+	int size;
+	
+	//if the result is already in the checkpoint there is nothing to simulate
+	if(BeginStage(&totalWaitTime, &size))
+		return EndStage(totalWaitTime, size);
 	
-	//get the size of the process list
-	int size = g_list_length(copy);
+	size = g_list_length(list);
+	
+	order = g_new(const Process*, size);
+	
+	count = ListOrder(list, order);
 					
-	//Sort the list depending on the chosen criteria
+	//Sort the order depending on the chosen criteria
 	if(!strcmp(criteria, "burst"))
-		copy = g_list_sort(copy, (GCompareFunc)compareBurst);
+		SortOrder(order, count, compareBurst, NULL);
 	
 	else
-		copy = g_list_sort(copy, (GCompareFunc)comparePriority);
+		SortOrder(order, count, comparePriority, NULL);
 		
 	
 	//while there are processes to process						
-	while(copy){
+	while(count){
 		
 		found = 0;
+		nextArrival = INT64_MAX;
 		
-		//traverse the list to find the next process
-		for(current = copy; current; current = current->next){
+		//traverse the order to find the next process
+		for(current = 0; current < count; current++){
 			
-			if(((Process*)current->data)->arriveTime <= timePassed){		//use the first process of the list that has arrived
+			if(order[current]->arriveTime <= timePassed){					//use the first process of the order that has arrived
 																													 
 				found = 1;													//if process is found stop searching
 				break;
 			}	
+			
+			if(order[current]->arriveTime < nextArrival)					//remember the earliest arrival in case the processor is idle
+				nextArrival = order[current]->arriveTime;
 		}
 		
 		if(found){
 			
-			timePassed += ((Process*)current->data)->burst;  				// increase timePassed by burst amount
+			timePassed += order[current]->burst;  							// increase timePassed by burst amount
 						
-			int waitTime = timePassed - ((Process*)current->data)->burst - ((Process*)current->data)->arriveTime; //get the wait time to the process
+			int64_t waitTime = timePassed - order[current]->burst - order[current]->arriveTime; //get the wait time to the process
 				
 			totalWaitTime += waitTime;										//add the process waitTime to the total waitTime
+			
+			if(completion)
+				completion[order[current]->index] = timePassed;				//record when the process finished
 							
-			copy = g_list_remove(copy, ((Process*)current->data));			// remove process from the list 
+			RemoveAt(order, &count, current);								// remove process from the order 
 		}
 		
 		else
-			timePassed++; 													// if a process has not arrived, increase the time and recheck
+			timePassed = nextArrival; 										// if a process has not arrived, jump to the next arrival and recheck
 	}
 		
 	
-	totalWaitTime /= size;		//calculate average wait time of algorithm
+	g_free(order); 				// deallocate memory of the order
+
+	return EndStage(totalWaitTime, size);
+}
+
+
+  //								 //
+ //            POLICIES             //
+//								   //
+
+
+const Policy policies[NUM_POLICIES] = {
+	{ "FCFS",					"fcfs",		ALG_FIRSTCOME,		NULL },
+	{ "NonPreemtive priority",	"npriority",ALG_NONPREEMPTIVE,	"priority" },
+	{ "NonPreemtive SJF",		"nsjf",		ALG_NONPREEMPTIVE,	"burst" },
+	{ "Preemtive priority",		"priority",	ALG_PREEMPTIVE,		"priority" },
+	{ "Preemtive SJF",			"sjf",		ALG_PREEMPTIVE,		"burst" },
+	{ "RoundRobin",				"rr",		ALG_ROUNDROBIN,		NULL },
+};
+
+//Runs the algorithm of a policy on the list and returns its average wait time
+double RunPolicy(const Policy *policy, GList* list, int64_t quantum, int64_t *completion){
 	
-	g_list_free(copy); 			// deallocate memory of the copy list
+	switch(policy->algorithm){
+		case ALG_NONPREEMPTIVE:	return NonPreemptive(list, policy->criteria, completion);
+		case ALG_PREEMPTIVE:	return Preemptive(list, policy->criteria, completion);
+		case ALG_ROUNDROBIN:	return RoundRobin(list, quantum, completion);
+		default:				return FirstCome(list, completion);
+	}
+}
 
-	printf("%f\n\n", totalWaitTime);
+//Returns the position in policies of the policy with the given option name, -1 if there is none
+int FindPolicy(const char *option){
+	
+	int policy;
+	
+	for(policy = 0; policy < NUM_POLICIES; policy++)
+		if(!strcmp(option, policies[policy].option))
+			return policy;
+	
+	return -1;
 }
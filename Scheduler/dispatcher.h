@@ -29,10 +29,26 @@
  *
  *          Oct  1  --  Optimized the code, now we copy the list to be able to handle the processes in a more elegant and efficient way
  *
+ *          Oct 18  --  Simulated time, bursts and wait sums are now 64-bit, include <stdint.h> before this header
+ *
+ *          Oct 18  --  Added SetCheckpoint and ClearCheckpoint
+ *
+ *          Oct 18  --  Algorithms return the average wait time and can record the completion time of every process
+ *
+ *          Oct 18  --  Algorithms no longer copy or change the processes of the list they are given
+ *
+ *          Oct 18  --  Added ProcessFields
+ *
+ *          Oct 18  --  SetCheckpoint takes the number of stages, to check the checkpoint read
+ *
+ *          Oct 18  --  Added the policies table, RunPolicy and FindPolicy, shared by every module that runs the policies
+ *
+ *          Oct 18  --  Added LoadProcessList, which replaces SortProcessList, include <stdio.h> before this header
+ *
  *
  * Error handling:
  *          None
- *			(The only error that could happen is if the timePassed variable reaches INT_MAX)
+ *			(Time is 64-bit, so microsecond traces can span thousands of years before timePassed overflows)
  *
  * Notes:
  *          We could modify the RoundRobin function for moving a process from its position to the last instead of eliminating and appending to the list
@@ -40,23 +56,60 @@
  * $Id$
  */
 
+/************************************************************** 
+ *             Declare the structures			              * 
+ **************************************************************/
+
+// compare two values without subtracting them, a difference of 64-bit times does not fit in an int
+#define COMPARE(a, b) (((a) > (b)) - ((a) < (b)))
+
+#define ALG_FIRSTCOME     0
+#define ALG_NONPREEMPTIVE 1
+#define ALG_PREEMPTIVE    2
+#define ALG_ROUNDROBIN    3
+
+// A policy of main: the algorithm and the criteria it is called with
+typedef struct {
+
+	char *name;						/* name printed with the results */
+	char *option;					/* name used in options and requests */
+	int algorithm;
+	char *criteria;
+
+}Policy;
+
+// The six policies of main, in the order it runs them
+#define NUM_POLICIES 6
+
+extern const Policy policies[NUM_POLICIES];
+
 /************************************************************** 
  *             Declare the functions			              * 
  **************************************************************/
 
-GList* SortProcessList(GList* ProccessList);
+int LoadProcessList(FILE *fp, int64_t *quantum, GList **list, char **error);
 
 void PrintProcessList(GList* processList);
 
-GList* CreateProcess(GList *processList, int pid, int arriveTime, int burst, int priority);
+void ProcessFields(GList* processList, int *pid, int64_t *arriveTime, int64_t *burst, int *priority);
+
+GList* CreateProcess(GList *processList, int pid, int64_t arriveTime, int64_t burst, int priority);
 
 void DestroyList(GList *processList);
 
-void Preemptive(GList* list, char *criteria);
+double Preemptive(GList* list, char *criteria, int64_t *completion);
+
+double RoundRobin(GList* list, int64_t quantum, int64_t *completion);
+
+double FirstCome(GList* list, int64_t *completion);
+
+double NonPreemptive(GList* list, char *criteria, int64_t *completion);
+
+double RunPolicy(const Policy *policy, GList* list, int64_t quantum, int64_t *completion);
 
-void RoundRobin(GList* list, int quantum);
+int FindPolicy(const char *option);
 
-void FirstCome(GList* list);
+void SetCheckpoint(GList *list, const char *path, int seconds, int stages);
 
-void NonPreemptive(GList* list, char *criteria);
+void ClearCheckpoint(void);
 
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: engine.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Faster versions of the dispatcher algorithms, they work on an
+ *			array of jobs with binary heaps instead of re-sorting and scanning a list
+ *
+ * References:
+ *          Same algorithms as dispatcher.c, with the same tie-breaking
+ *
+ * Restrictions:
+ *          Results match dispatcher.c as long as every pid is unique and every burst and the quantum are positive
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created with EngineFirstCome, EngineNonPreemptive, EnginePreemptive and EngineRoundRobin
+ *
+ *          Oct 18 2026 -- The algorithms use a workspace given by the caller, so running many workloads allocates nothing
+ *
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          dispatcher.c picks, among the processes that arrived, the first one of a list sorted by
+ *			(key, arrival, pid). Here that list is a heap with the same order, so each decision is O(log n)
+ *			and the preemptive algorithms run until the next arrival instead of one time unit at a time
+ *
+ * $Id$
+ */
+
+#include <glib.h>				 /* Used for g_new and g_free */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <string.h>                                /* Used for strcmp */
+#include <stdio.h>                            /* Used for the FILE type */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include "dispatcher.h"                /* Used for Policy and COMPARE */
+#include "engine.h"                                /* Function header */
+
+// what is compared first when ordering the jobs of a queue, ties are broken by arrival, then pid, then index
+#define KEY_ARRIVAL  0
+#define KEY_PRIORITY 1
+#define KEY_BURST    2
+#define KEY_INDEX    3
+
+// Arrays used by the algorithms, big enough for capacity jobs
+struct EngineWorkspace {
+
+	int capacity;
+
+	int64_t *arriveTime;
+	int64_t *burstLeft;
+	int *arrivals;					/* heap of the arrivals queue */
+	int *ready;						/* heap of the ready queue */
+
+};
+
+// Binary heap of job indexes, the first one is the job dispatcher.c would find first in its list
+typedef struct {
+
+	const Job *jobs;
+	const int64_t *burstLeft;
+	const int64_t *arriveTime;		/* arrival used for ordering, RoundRobin moves it to the time the job is requeued */
+	int key;
+
+	int *heap;
+	int size;
+
+}Queue;
+
+// Returns 1 if job a goes before job b in the queue
+static int Before(const Queue *queue, int a, int b){
+
+	int compare = 0;
+
+	switch(queue->key){
+
+		case KEY_PRIORITY:
+			compare = COMPARE(queue->jobs[a].priority, queue->jobs[b].priority);
+			break;
+
+		case KEY_BURST:
+			compare = COMPARE(queue->burstLeft[a], queue->burstLeft[b]);
+			break;
+
+		case KEY_INDEX:
+			return a < b;
+	}
+
+	if(compare == 0)
+		compare = COMPARE(queue->arriveTime[a], queue->arriveTime[b]);
+
+	if(compare == 0)
+		compare = COMPARE(queue->jobs[a].pid, queue->jobs[b].pid);
+
+	if(compare == 0)
+		compare = COMPARE(a, b);
+
+	return compare < 0;
+}
+
+static void Push(Queue *queue, int job){
+
+	int position = queue->size++;
+	int parent;
+
+	while(position > 0){
+
+		parent = (position - 1) / 2;
+
+		if(!Before(queue, job, queue->heap[parent]))
+			break;
+
+		queue->heap[position] = queue->heap[parent];
+		position = parent;
+	}
+
+	queue->heap[position] = job;
+}
+
+// Moves the job at the top down to its place, used after removing the top or after its key grew
+static void SiftDown(Queue *queue){
+
+	int job = queue->heap[0];
+	int position = 0, child;
+
+	while((child = 2 * position + 1) < queue->size){
+
+		if(child + 1 < queue->size && Before(queue, queue->heap[child + 1], queue->heap[child]))
+			child++;
+
+		if(!Before(queue, queue->heap[child], job))
+			break;
+
+		queue->heap[position] = queue->heap[child];
+		position = child;
+	}
+
+	queue->heap[position] = job;
+}
+
+static int Pop(Queue *queue){
+
+	int job = queue->heap[0];
+
+	queue->heap[0] = queue->heap[--queue->size];
+
+	if(queue->size)
+		SiftDown(queue);
+
+	return job;
+}
+
+// Resets the workspace for the jobs given: copies arrivals and bursts, which the algorithms change, and
+// fills the arrivals queue with every job ordered by arrival. The ready queue starts empty
+static void Prepare(EngineWorkspace *workspace, const Job *jobs, int count, Queue *arrivals, Queue *ready){
+
+	int i;
+
+	for(i = 0; i < count; i++){
+		workspace->arriveTime[i] = jobs[i].arriveTime;
+		workspace->burstLeft[i] = jobs[i].burst;
+	}
+
+	arrivals->jobs = jobs;
+	arrivals->burstLeft = workspace->burstLeft;
+	arrivals->arriveTime = workspace->arriveTime;
+	arrivals->key = KEY_ARRIVAL;
+	arrivals->heap = workspace->arrivals;
+	arrivals->size = 0;
+
+	for(i = 0; i < count; i++)
+		Push(arrivals, i);
+
+	*ready = *arrivals;
+	ready->heap = workspace->ready;
+	ready->size = 0;
+}
+
+// Records a finished job, returns its wait time
+static int64_t Finish(const Job *job, int index, int64_t timePassed, int64_t *completion){
+
+	if(completion)
+		completion[index] = timePassed;
+
+	return timePassed - job->burst - job->arriveTime;
+}
+
+
+// Allocates the arrays needed to run workloads of up to capacity jobs
+EngineWorkspace* NewWorkspace(int capacity){
+
+	EngineWorkspace *workspace = g_new(EngineWorkspace, 1);
+
+	workspace->capacity = capacity;
+	workspace->arriveTime = g_new(int64_t, capacity);
+	workspace->burstLeft = g_new(int64_t, capacity);
+	workspace->arrivals = g_new(int, capacity);
+	workspace->ready = g_new(int, capacity);
+
+	return workspace;
+}
+
+void FreeWorkspace(EngineWorkspace *workspace){
+
+	g_free(workspace->arriveTime);
+	g_free(workspace->burstLeft);
+	g_free(workspace->arrivals);
+	g_free(workspace->ready);
+	g_free(workspace);
+}
+
+
+  //								 //
+ // DISPATCHER ALGORITHM FUNCTIONS  //
+//								   //
+
+double EngineFirstCome(const Job *jobs, int count, int64_t *completion, EngineWorkspace *workspace){
+
+	int64_t totalWaitTime = 0, timePassed = 0;
+	Queue arrivals, ready;
+	int job;
+
+	Prepare(workspace, jobs, count, &arrivals, &ready);
+
+	while(arrivals.size){
+
+		job = Pop(&arrivals);
+
+		if(jobs[job].arriveTime > timePassed)
+			timePassed = jobs[job].arriveTime;						//processor is idle until the job arrives
+
+		timePassed += jobs[job].burst;
+		totalWaitTime += Finish(&jobs[job], job, timePassed, completion);
+	}
+
+	return (double)totalWaitTime / count;
+}
+
+double EngineNonPreemptive(const Job *jobs, int count, char *criteria, int64_t *completion, EngineWorkspace *workspace){
+
+	int64_t *arriveTime = workspace->arriveTime;
+	int64_t totalWaitTime = 0, timePassed = 0;
+	Queue arrivals, ready;
+	int job;
+
+	Prepare(workspace, jobs, count, &arrivals, &ready);
+
+	ready.key = strcmp(criteria, "burst") ? KEY_PRIORITY : KEY_BURST;
+
+	while(arrivals.size || ready.size){
+
+		//every job that arrived can be chosen
+		while(arrivals.size && arriveTime[arrivals.heap[0]] <= timePassed)
+			Push(&ready, Pop(&arrivals));
+
+		if(!ready.size){
+			timePassed = arriveTime[arrivals.heap[0]];				//processor is idle, jump to the next arrival
+			continue;
+		}
+
+		job = Pop(&ready);
+
+		timePassed += jobs[job].burst;
+		totalWaitTime += Finish(&jobs[job], job, timePassed, completion);
+	}
+
+	return (double)totalWaitTime / count;
+}
+
+double EnginePreemptive(const Job *jobs, int count, char *criteria, int64_t *completion, EngineWorkspace *workspace){
+
+	int64_t *arriveTime = workspace->arriveTime;
+	int64_t *burstLeft = workspace->burstLeft;
+	int64_t totalWaitTime = 0, timePassed = 0, run;
+	Queue arrivals, ready;
+	int job;
+
+	Prepare(workspace, jobs, count, &arrivals, &ready);
+
+	//any other criteria keeps the order of the list, dispatcher.c does not sort it
+	if(!strcmp(criteria, "priority"))
+		ready.key = KEY_PRIORITY;
+	else if(!strcmp(criteria, "burst"))
+		ready.key = KEY_BURST;
+	else
+		ready.key = KEY_INDEX;
+
+	while(arrivals.size || ready.size){
+
+		while(arrivals.size && arriveTime[arrivals.heap[0]] <= timePassed)
+			Push(&ready, Pop(&arrivals));
+
+		if(!ready.size){
+			timePassed = arriveTime[arrivals.heap[0]];
+			continue;
+		}
+
+		//the first job keeps the processor until it finishes or another job arrives,
+		//its burst only goes down so no job that already arrived can overtake it
+		job = ready.heap[0];
+		run = burstLeft[job];
+
+		if(arrivals.size && arriveTime[arrivals.heap[0]] - timePassed < run)
+			run = arriveTime[arrivals.heap[0]] - timePassed;
+
+		timePassed += run;
+		burstLeft[job] -= run;
+
+		if(burstLeft[job] == 0){
+			Pop(&ready);
+			totalWaitTime += Finish(&jobs[job], job, timePassed, completion);
+		}
+	}
+
+	return (double)totalWaitTime / count;
+}
+
+double EngineRoundRobin(const Job *jobs, int count, int64_t quantum, int64_t *completion, EngineWorkspace *workspace){
+
+	int64_t *arriveTime = workspace->arriveTime;
+	int64_t *burstLeft = workspace->burstLeft;
+	int64_t totalWaitTime = 0, timePassed = 0, slice;
+	Queue queue, ready;
+	int job;
+
+	//dispatcher.c keeps one list sorted by arrival and requeues a job with its arrival moved to the current time
+	Prepare(workspace, jobs, count, &queue, &ready);
+
+	while(queue.size){
+
+		job = Pop(&queue);
+
+		if(arriveTime[job] > timePassed)
+			timePassed = arriveTime[job];							//processor is idle until the job arrives
+
+		slice = burstLeft[job] < quantum ? burstLeft[job] : quantum;
+
+		timePassed += slice;
+		burstLeft[job] -= slice;
+
+		if(burstLeft[job] == 0)
+			totalWaitTime += Finish(&jobs[job], job, timePassed, completion);
+
+		else{
+			arriveTime[job] = timePassed;
+			Push(&queue, job);
+		}
+	}
+
+	return (double)totalWaitTime / count;
+}
+
+// Runs the algorithm of a policy of dispatcher.h on the jobs and returns its average wait time
+double EngineRunPolicy(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion, EngineWorkspace *workspace){
+
+	switch(policy->algorithm){
+		case ALG_NONPREEMPTIVE:	return EngineNonPreemptive(jobs, count, policy->criteria, completion, workspace);
+		case ALG_PREEMPTIVE:	return EnginePreemptive(jobs, count, policy->criteria, completion, workspace);
+		case ALG_ROUNDROBIN:	return EngineRoundRobin(jobs, count, quantum, completion, workspace);
+		default:				return EngineFirstCome(jobs, count, completion, workspace);
+	}
+}
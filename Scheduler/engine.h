@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: engine.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Faster versions of the dispatcher algorithms, they work on an
+ *			array of jobs with binary heaps instead of re-sorting and scanning a list
+ *
+ * References:
+ *          Same algorithms as dispatcher.c, with the same tie-breaking
+ *
+ * Restrictions:
+ *          Results match dispatcher.c as long as every pid is unique and every burst and the quantum are positive
+ *			Include <stdint.h>, <glib.h> and dispatcher.h before this header
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created with EngineFirstCome, EngineNonPreemptive, EnginePreemptive and EngineRoundRobin
+ *
+ *          Oct 18 2026 -- Added NewWorkspace and FreeWorkspace, a workspace can run any workload of up to its capacity
+ *
+ *          Oct 18 2026 -- Added EngineRunPolicy, runs a policy of the table in dispatcher.h
+ *
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          verify.c compares these functions against dispatcher.c
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the structures			              *
+ **************************************************************/
+
+// Fields of a process as read from the input file
+typedef struct {
+
+	int pid;
+	int priority;
+	int64_t arriveTime;
+	int64_t burst;
+
+}Job;
+
+// Arrays the algorithms work on, one per thread since the algorithms change them
+typedef struct EngineWorkspace EngineWorkspace;
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+EngineWorkspace* NewWorkspace(int capacity);
+
+void FreeWorkspace(EngineWorkspace *workspace);
+
+double EngineFirstCome(const Job *jobs, int count, int64_t *completion, EngineWorkspace *workspace);
+
+double EngineNonPreemptive(const Job *jobs, int count, char *criteria, int64_t *completion, EngineWorkspace *workspace);
+
+double EnginePreemptive(const Job *jobs, int count, char *criteria, int64_t *completion, EngineWorkspace *workspace);
+
+double EngineRoundRobin(const Job *jobs, int count, int64_t quantum, int64_t *completion, EngineWorkspace *workspace);
+
+double EngineRunPolicy(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion, EngineWorkspace *workspace);
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: montecarlo.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Run the dispatcher algorithms on thousands of random workloads drawn from a
+ *			description of the arrival rate, burst distribution and priority mix
+ *
+ * References:
+ *          Confidence intervals use the normal approximation, fine for the number of replicas used
+ *
+ * Restrictions:
+ *          Uses engine.c, so the results are those of dispatcher.c as checked by verify.c
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          MonteCarlo returns EXIT_FAILURE if the description can not be read
+ *
+ * File formats:
+ *          The description has one setting per line, # starts a comment:
+ *
+ *          processes 1000                  processes in each replica
+ *          quantum 4                       quantum of RoundRobin
+ *          interarrival 10                 mean time between arrivals, exponential (1 / arrival rate)
+ *          burst exponential 8             or: burst uniform 1 20, burst constant 5
+ *          priority 5 3 2                  weight of priority 0, 1, 2...
+ *
+ * Notes:
+ *          Replicas are shared among the threads, every thread has its own random generator,
+ *			workload and engine workspace, allocated once. The generator is seeded again for every
+ *			replica with seed + replica, so the results do not depend on the number of threads
+ *
+ * $Id$
+ */
+
+#include <glib.h>				 /* Used for threads and GRand */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <stdio.h>                                /* Used for printf */
+#include <string.h>                                /* Used for strcmp */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <inttypes.h>                 /* Used for the SCNd64 format */
+#include <math.h>                           /* Used for log and sqrt */
+#include "FileIO.h"                               /* Used for ErrorMsg */
+#include "dispatcher.h"                   /* Used for the policies */
+#include "engine.h"                  /* Algorithms used for every replica */
+#include "montecarlo.h"                            /* Function header */
+
+#define MAX_PRIORITIES 64
+#define MAX_LINE       256
+
+#define BURST_EXPONENTIAL 0
+#define BURST_UNIFORM     1
+#define BURST_CONSTANT    2
+
+// Stochastic workload read from the description file
+typedef struct {
+
+	int processes;
+	int64_t quantum;
+	double interarrival;
+
+	int burst;
+	double burstA, burstB;			/* mean, minimum and maximum or value, depending on the distribution */
+
+	int priorities;
+	double weights[MAX_PRIORITIES];
+	double totalWeight;
+
+}Description;
+
+// State shared by the threads
+typedef struct {
+
+	const Description *description;
+	const int *selected;			/* 1 for every policy to run */
+	int replicas;
+	unsigned int seed;
+
+	volatile gint next;				/* next replica to run */
+	double *results;				/* average wait time of every replica and policy */
+
+}Experiment;
+
+// Reads the description file, returns EXIT_FAILURE if some setting is missing or wrong
+static int ReadDescription(const char *path, Description *description){
+
+	char line[MAX_LINE], kind[MAX_LINE], *comment, *field;
+	FILE *fp = fopen(path, "r");
+	int ok = 1, i;
+
+	memset(description, 0, sizeof(Description));
+
+	if(!fp){
+		ErrorMsg("ReadDescription", "description file does not exist");
+		return (EXIT_FAILURE);
+	}
+
+	while(ok && fgets(line, sizeof(line), fp)){
+
+		if((comment = strchr(line, '#')))
+			*comment = '\0';
+
+		if(sscanf(line, "%s", kind) != 1)
+			continue;											//empty line
+
+		field = strstr(line, kind) + strlen(kind);
+
+		if(!strcmp(kind, "processes"))
+			ok = sscanf(field, "%d", &description->processes) == 1;
+
+		else if(!strcmp(kind, "quantum"))
+			ok = sscanf(field, "%" SCNd64, &description->quantum) == 1;
+
+		else if(!strcmp(kind, "interarrival"))
+			ok = sscanf(field, "%lf", &description->interarrival) == 1;
+
+		else if(!strcmp(kind, "burst")){
+
+			ok = sscanf(field, "%s", kind) == 1;
+			field = strstr(field, kind) + strlen(kind);
+
+			if(ok && !strcmp(kind, "exponential")){
+				description->burst = BURST_EXPONENTIAL;
+				ok = sscanf(field, "%lf", &description->burstA) == 1;
+			}
+			else if(ok && !strcmp(kind, "uniform")){
+				description->burst = BURST_UNIFORM;
+				ok = sscanf(field, "%lf %lf", &description->burstA, &description->burstB) == 2;
+			}
+			else if(ok && !strcmp(kind, "constant")){
+				description->burst = BURST_CONSTANT;
+				ok = sscanf(field, "%lf", &description->burstA) == 1;
+			}
+			else
+				ok = 0;
+		}
+
+		else if(!strcmp(kind, "priority")){
+
+			int read;
+
+			while(description->priorities < MAX_PRIORITIES &&
+				  sscanf(field, "%lf%n", &description->weights[description->priorities], &read) == 1){
+
+				description->totalWeight += description->weights[description->priorities++];
+				field += read;
+			}
+		}
+
+		else
+			ok = 0;
+	}
+
+	fclose(fp);
+
+	if(!ok){
+		ErrorMsg("ReadDescription", "unknown or malformed setting in the description");
+		return (EXIT_FAILURE);
+	}
+
+	if(description->processes < 1 || description->quantum < 1 || description->interarrival < 0 || description->burstA <= 0){
+		ErrorMsg("ReadDescription", "processes, quantum, interarrival and burst are needed and must be positive");
+		return (EXIT_FAILURE);
+	}
+
+	if(description->burst == BURST_UNIFORM && description->burstA > description->burstB){
+		ErrorMsg("ReadDescription", "the minimum of a uniform burst can not be larger than its maximum");
+		return (EXIT_FAILURE);
+	}
+
+	for(i = 0; i < description->priorities; i++)
+		if(description->weights[i] < 0){
+			ErrorMsg("ReadDescription", "priority weights can not be negative");
+			return (EXIT_FAILURE);
+		}
+
+	//without a priority mix every process gets priority 0
+	if(description->totalWeight <= 0){
+		description->priorities = 1;
+		description->weights[0] = description->totalWeight = 1;
+	}
+
+	return (EXIT_SUCCESS);
+}
+
+static double Exponential(GRand *rand, double mean){
+
+	return -mean * log(1.0 - g_rand_double(rand));
+}
+
+// Draws a positive burst from the distribution of the description
+static int64_t Burst(GRand *rand, const Description *description){
+
+	double burst;
+
+	switch(description->burst){
+		case BURST_EXPONENTIAL:	burst = Exponential(rand, description->burstA);								break;
+		case BURST_UNIFORM:		burst = g_rand_double_range(rand, description->burstA, description->burstB + 1);	break;
+		default:				burst = description->burstA;												break;
+	}
+
+	return burst < 1 ? 1 : (int64_t)burst;
+}
+
+static int Priority(GRand *rand, const Description *description){
+
+	double pick = g_rand_double(rand) * description->totalWeight;
+	int priority;
+
+	for(priority = 0; priority < description->priorities - 1; priority++){
+
+		if(pick < description->weights[priority])
+			break;
+
+		pick -= description->weights[priority];
+	}
+
+	return priority;
+}
+
+// Fills jobs with one replica, already in the arrival order main gives to the list
+static void Generate(GRand *rand, const Description *description, Job *jobs){
+
+	int64_t arriveTime = 0;
+	int i;
+
+	for(i = 0; i < description->processes; i++){
+
+		arriveTime += (int64_t)(Exponential(rand, description->interarrival) + 0.5);
+
+		jobs[i].pid = i + 1;
+		jobs[i].arriveTime = arriveTime;
+		jobs[i].burst = Burst(rand, description);
+		jobs[i].priority = Priority(rand, description);
+	}
+}
+
+// Takes replicas until there are none left, everything it needs is allocated before the first one
+static gpointer Worker(gpointer data){
+
+	Experiment *experiment = data;
+	const Description *description = experiment->description;
+	Job *jobs = g_new(Job, description->processes);
+	EngineWorkspace *workspace = NewWorkspace(description->processes);
+	GRand *rand = g_rand_new_with_seed(experiment->seed);
+	double *result;
+	int replica, policy;
+
+	while((replica = g_atomic_int_add(&experiment->next, 1)) < experiment->replicas){
+
+		g_rand_set_seed(rand, experiment->seed + replica);
+		Generate(rand, description, jobs);
+
+		result = &experiment->results[(size_t)replica * NUM_POLICIES];
+
+		for(policy = 0; policy < NUM_POLICIES; policy++){
+
+			if(!experiment->selected[policy])
+				continue;
+
+			result[policy] = EngineRunPolicy(&policies[policy], jobs, description->processes, description->quantum, NULL, workspace);
+		}
+	}
+
+	g_rand_free(rand);
+	FreeWorkspace(workspace);
+	g_free(jobs);
+
+	return NULL;
+}
+
+// Marks the policies named in a comma separated list, all of them if the list is NULL
+static int SelectPolicies(char *selection, int *selected){
+
+	char *name;
+	int policy;
+
+	for(policy = 0; policy < NUM_POLICIES; policy++)
+		selected[policy] = selection == NULL;
+
+	if(!selection)
+		return (EXIT_SUCCESS);
+
+	for(name = strtok(selection, ","); name; name = strtok(NULL, ",")){
+
+		if((policy = FindPolicy(name)) < 0){
+			ErrorMsg("SelectPolicies", "unknown policy, use fcfs, npriority, nsjf, priority, sjf or rr");
+			return (EXIT_FAILURE);
+		}
+
+		selected[policy] = 1;
+	}
+
+	return (EXIT_SUCCESS);
+}
+
+// Runs the replicas on the given number of threads, 0 uses every processor, and prints the mean of the
+// average wait time of every policy with its 95% confidence interval
+int MonteCarlo(const char *path, int replicas, int threads, char *selection, unsigned int seed){
+
+	Description description;
+	Experiment experiment;
+	int selected[NUM_POLICIES];
+	GThread **workers;
+	double mean, variance, value;
+	int i, policy;
+
+	if(ReadDescription(path, &description) == EXIT_FAILURE || SelectPolicies(selection, selected) == EXIT_FAILURE)
+		return (EXIT_FAILURE);
+
+	if(replicas < 1)
+		replicas = 1;
+
+	if(threads < 1)
+		threads = g_get_num_processors();
+
+	if(threads > replicas)
+		threads = replicas;
+
+	experiment.description = &description;
+	experiment.selected = selected;
+	experiment.replicas = replicas;
+	experiment.seed = seed;
+	experiment.next = 0;
+	experiment.results = g_new(double, (size_t)replicas * NUM_POLICIES);
+
+	workers = g_new(GThread*, threads);
+
+	for(i = 0; i < threads; i++)
+		workers[i] = g_thread_new("replicas", Worker, &experiment);
+
+	for(i = 0; i < threads; i++)
+		g_thread_join(workers[i]);
+
+	printf("%d replicas of %d processes on %d threads, seed %u\n\n", replicas, description.processes, threads, seed);
+
+	for(policy = 0; policy < NUM_POLICIES; policy++){
+
+		if(!selected[policy])
+			continue;
+
+		//results are added in replica order so the sums do not depend on which thread ran each replica
+		mean = variance = 0;
+
+		for(i = 0; i < replicas; i++)
+			mean += experiment.results[(size_t)i * NUM_POLICIES + policy];
+
+		mean /= replicas;
+
+		for(i = 0; i < replicas; i++){
+			value = experiment.results[(size_t)i * NUM_POLICIES + policy] - mean;
+			variance += value * value;
+		}
+
+		variance = replicas > 1 ? variance / (replicas - 1) : 0;
+
+		printf("%s average wait time is: %f +/- %f (95%% confidence, std dev %f)\n\n",
+			   policies[policy].name, mean, 1.96 * sqrt(variance / replicas), sqrt(variance));
+	}
+
+	g_free(workers);
+	g_free(experiment.results);
+
+	return (EXIT_SUCCESS);
+}
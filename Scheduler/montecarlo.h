@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: montecarlo.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Run the dispatcher algorithms on thousands of random workloads drawn from a
+ *			description of the arrival rate, burst distribution and priority mix
+ *
+ * References:
+ *          Confidence intervals use the normal approximation, fine for the number of replicas used
+ *
+ * Restrictions:
+ *          Uses engine.c, so the results are those of dispatcher.c as checked by verify.c
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          MonteCarlo returns EXIT_FAILURE if the description can not be read
+ *
+ * Notes:
+ *          Run with: scheduler -m description.txt [-n replicas] [-j threads] [-p policies] [-r seed]
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+int MonteCarlo(const char *path, int replicas, int threads, char *selection, unsigned int seed);
@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: multicore.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Run the dispatcher policies on a machine with several CPUs and measure how much
+ *			time is lost when processes move between CPUs
+ *
+ * References:
+ *          Run queue per CPU with work stealing, like most multiprocessor schedulers
+ *
+ * Restrictions:
+ *          Every burst has to be positive, and the quantum too for RoundRobin and Fair
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *          Oct 18 2026 -- RoundRobin and Fair order their queues by the time a process was queued and then its pid, so
+ *                         one CPU gives the results of dispatcher.c
+ *
+ *          Oct 18 2026 -- Simulate jumps from event to event instead of one time unit at a time
+ *
+ *          Oct 18 2026 -- The policies of main come from the table of dispatcher.h. Added SingleCore, checked by verify.c
+ *
+ *          Oct 18 2026 -- Run queues are binary heaps instead of lists scanned for the best process, topologies
+ *                         are limited to MAX_CPUS
+ *
+ *
+ * Error handling:
+ *          MultiCore returns EXIT_FAILURE if the topology can not be read or has more than MAX_CPUS CPUs
+ *
+ * File formats:
+ *          The topology has one setting per line, # starts a comment, see topology.txt:
+ *
+ *          sockets 2                       sockets, every socket is a NUMA node
+ *          cores 4                         cores in every socket
+ *          threads 2                       hardware threads (CPUs) in every core
+ *          penalty core 1                  time lost moving to another thread of the same core,
+ *          penalty socket 4                to another core of the same socket
+ *          penalty node 20                 or to another NUMA node
+ *
+ * Notes:
+ *          Every CPU has its own queue. The balancer places a process on the CPU with the fewest
+ *			processes, a CPU with nothing in its queue steals the best process of the longest queue.
+ *			With affinity, a process that already ran goes back to its last CPU unless that CPU has
+ *			more than IMBALANCE processes over the least loaded one, and ties between CPUs, for placing
+ *			and for stealing from queues of the same length, go to the closest one. A process that runs
+ *			on another CPU than the last one needs the penalty of their distance added to its burst,
+ *			its caches are cold.
+ *
+ *          Nothing changes between arrivals, completions and ends of quantum, so the simulation jumps
+ *			from one of these events to the next.
+ *
+ *          Every policy is run with and without affinity, so the report shows what affinity saves.
+ *			Fair is only in this model: the process that has run the least goes first, for a quantum
+ *
+ * $Id$
+ */
+
+#include <glib.h>				  /* Used for lists and g_new */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <stdio.h>                                /* Used for printf */
+#include <string.h>                                /* Used for strcmp */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <inttypes.h>                /* Used for the PRId64 format */
+#include "FileIO.h"                               /* Used for ErrorMsg */
+#include "dispatcher.h"                   /* Used for ProcessFields */
+#include "engine.h"                                /* Used for Job */
+#include "multicore.h"                             /* Function header */
+
+#define MAX_LINE  256
+#define MAX_CPUS  4096
+#define IMBALANCE 1
+
+#define DISTANCE_NONE   -1
+#define DISTANCE_CORE   0
+#define DISTANCE_SOCKET 1
+#define DISTANCE_NODE   2
+#define DISTANCES       3
+
+#define KEY_ARRIVAL  0
+#define KEY_PRIORITY 1
+#define KEY_BURST    2
+#define KEY_LEFT     3
+#define KEY_QUEUED   4
+#define KEY_SERVICE  5
+
+// How the CPUs pick the next process of their queue
+typedef struct {
+
+	char *name;
+	int key;						/* the process with the lowest key runs first */
+	int preemptive;					/* a better process waiting on the CPU takes it */
+	int sliced;						/* the process leaves the CPU after a quantum */
+
+}Discipline;
+
+// Fair is only in this model, it runs after the six policies of main
+static const Discipline fair = { "Fair", KEY_SERVICE, 0, 1 };
+
+#define NUM_DISCIPLINES (NUM_POLICIES + 1)
+
+// Machine read from the topology file, CPU number (socket * cores + core) * threads + thread
+typedef struct {
+
+	int sockets;
+	int cores;						/* in every socket */
+	int threads;					/* in every core */
+	int cpus;
+	int64_t penalty[DISTANCES];
+
+}Topology;
+
+// What a run changes of a process, the Job itself is never changed
+typedef struct {
+
+	int64_t burstLeft;				/* burst plus migration penalties not run yet */
+	int64_t service;				/* time run so far, key of Fair */
+	int64_t queued;					/* time it was last queued, key of RoundRobin like the moved arrival of dispatcher.c */
+	int64_t slice;					/* time run since it took the CPU */
+	int lastCpu;					/* -1 until it runs */
+
+}Task;
+
+// Processes waiting for a CPU, a binary heap whose first process is the one Before puts first.
+// Only the running process changes its key, so the order of the waiting ones never goes stale
+typedef struct {
+
+	int *heap;
+	int size;
+	int capacity;					/* grows as needed, a process waits in one queue at a time */
+
+}RunQueue;
+
+// State of a run of one policy
+typedef struct {
+
+	const Topology *topology;
+	const Discipline *discipline;
+	const Job *jobs;
+	int count;
+	int64_t quantum;
+	int affinity;					/* 0 places processes without looking at where they ran */
+
+	Task *tasks;
+	RunQueue *queues;				/* processes waiting for every CPU */
+	int *running;					/* process on every CPU, -1 if idle */
+	int64_t timePassed;
+	int64_t *completion;			/* time every process finished, if not NULL */
+
+	int64_t migrations[DISTANCES];
+	int64_t cost;					/* time lost to migrations */
+	int64_t busy;					/* time the CPUs spent running processes, cost included */
+	int64_t totalWaitTime;
+
+}Machine;
+
+// Reads the topology file, returns EXIT_FAILURE if some setting is missing or wrong
+static int ReadTopology(const char *path, Topology *topology){
+
+	char line[MAX_LINE], kind[MAX_LINE], *comment, *field;
+	FILE *fp = fopen(path, "r");
+	int ok = 1;
+
+	memset(topology, 0, sizeof(Topology));
+
+	if(!fp){
+		ErrorMsg("ReadTopology", "topology file does not exist");
+		return (EXIT_FAILURE);
+	}
+
+	while(ok && fgets(line, sizeof(line), fp)){
+
+		if((comment = strchr(line, '#')))
+			*comment = '\0';
+
+		if(sscanf(line, "%s", kind) != 1)
+			continue;											//empty line
+
+		field = strstr(line, kind) + strlen(kind);
+
+		if(!strcmp(kind, "sockets"))
+			ok = sscanf(field, "%d", &topology->sockets) == 1;
+
+		else if(!strcmp(kind, "cores"))
+			ok = sscanf(field, "%d", &topology->cores) == 1;
+
+		else if(!strcmp(kind, "threads"))
+			ok = sscanf(field, "%d", &topology->threads) == 1;
+
+		else if(!strcmp(kind, "penalty")){
+
+			ok = sscanf(field, "%s", kind) == 1;
+			field = strstr(field, kind) + strlen(kind);
+
+			if(ok && !strcmp(kind, "core"))
+				ok = sscanf(field, "%" SCNd64, &topology->penalty[DISTANCE_CORE]) == 1;
+			else if(ok && !strcmp(kind, "socket"))
+				ok = sscanf(field, "%" SCNd64, &topology->penalty[DISTANCE_SOCKET]) == 1;
+			else if(ok && !strcmp(kind, "node"))
+				ok = sscanf(field, "%" SCNd64, &topology->penalty[DISTANCE_NODE]) == 1;
+			else
+				ok = 0;
+		}
+
+		else
+			ok = 0;
+	}
+
+	fclose(fp);
+
+	if(!ok){
+		ErrorMsg("ReadTopology", "unknown or malformed setting in the topology");
+		return (EXIT_FAILURE);
+	}
+
+	if(topology->sockets < 1 || topology->cores < 1 || topology->threads < 1 ||
+	   topology->penalty[DISTANCE_CORE] < 0 || topology->penalty[DISTANCE_SOCKET] < 0 || topology->penalty[DISTANCE_NODE] < 0){
+		ErrorMsg("ReadTopology", "sockets, cores and threads are needed and must be positive, penalties can not be negative");
+		return (EXIT_FAILURE);
+	}
+
+	//checked one factor at a time, the product could overflow
+	if(topology->cores > MAX_CPUS / topology->sockets || topology->threads > MAX_CPUS / (topology->sockets * topology->cores)){
+		ErrorMsg("ReadTopology", "the topology has more CPUs than the simulation allows");
+		return (EXIT_FAILURE);
+	}
+
+	topology->cpus = topology->sockets * topology->cores * topology->threads;
+
+	return (EXIT_SUCCESS);
+}
+
+// The discipline of a policy of main, criteria other than burst are priority like in dispatcher.c
+static Discipline FromPolicy(const Policy *policy){
+
+	Discipline discipline = { policy->name, KEY_ARRIVAL, 0, 0 };
+
+	switch(policy->algorithm){
+
+		case ALG_NONPREEMPTIVE:
+			discipline.key = strcmp(policy->criteria, "burst") ? KEY_PRIORITY : KEY_BURST;
+			break;
+
+		case ALG_PREEMPTIVE:
+			discipline.key = strcmp(policy->criteria, "burst") ? KEY_PRIORITY : KEY_LEFT;
+			discipline.preemptive = 1;
+			break;
+
+		case ALG_ROUNDROBIN:
+			discipline.key = KEY_QUEUED;
+			discipline.sliced = 1;
+			break;
+	}
+
+	return discipline;
+}
+
+// How far apart two CPUs are, DISTANCE_NONE if they are the same
+static int Distance(const Topology *topology, int a, int b){
+
+	if(a == b)
+		return DISTANCE_NONE;
+
+	if(a / topology->threads == b / topology->threads)
+		return DISTANCE_CORE;
+
+	if(a / (topology->threads * topology->cores) == b / (topology->threads * topology->cores))
+		return DISTANCE_SOCKET;
+
+	return DISTANCE_NODE;
+}
+
+// Returns 1 if process a runs before process b, ties go to the earliest arrival, then to the lowest pid and
+// then to the list order, the order of dispatcher.c. RoundRobin and Fair take the time a process was queued
+// as its arrival, like RoundRobin in dispatcher.c moves the arrival of a process it puts back in the list
+static int Before(const Machine *machine, int a, int b){
+
+	const Job *jobs = machine->jobs;
+	const Task *tasks = machine->tasks;
+	int compare = 0;
+
+	switch(machine->discipline->key){
+		case KEY_PRIORITY:	compare = COMPARE(jobs[a].priority, jobs[b].priority);		break;
+		case KEY_BURST:		compare = COMPARE(jobs[a].burst, jobs[b].burst);			break;
+		case KEY_LEFT:		compare = COMPARE(tasks[a].burstLeft, tasks[b].burstLeft);	break;
+		case KEY_SERVICE:	compare = COMPARE(tasks[a].service, tasks[b].service);		break;
+	}
+
+	if(!compare && machine->discipline->sliced)
+		compare = COMPARE(tasks[a].queued, tasks[b].queued);
+
+	else if(!compare)
+		compare = COMPARE(jobs[a].arriveTime, jobs[b].arriveTime);
+
+	if(!compare)
+		compare = COMPARE(jobs[a].pid, jobs[b].pid);
+
+	if(!compare)
+		compare = COMPARE(a, b);
+
+	return compare < 0;
+}
+
+// Processes waiting for the CPU plus the one running on it
+static int Load(const Machine *machine, int cpu){
+
+	return machine->queues[cpu].size + (machine->running[cpu] >= 0);
+}
+
+static void Queue(Machine *machine, int cpu, int process){
+
+	RunQueue *queue = &machine->queues[cpu];
+	int position, parent;
+
+	machine->tasks[process].queued = machine->timePassed;
+
+	if(queue->size == queue->capacity){
+		queue->capacity = queue->capacity ? 2 * queue->capacity : 16;
+		queue->heap = g_renew(int, queue->heap, queue->capacity);
+	}
+
+	position = queue->size++;
+
+	while(position > 0){
+
+		parent = (position - 1) / 2;
+
+		if(!Before(machine, process, queue->heap[parent]))
+			break;
+
+		queue->heap[position] = queue->heap[parent];
+		position = parent;
+	}
+
+	queue->heap[position] = process;
+}
+
+// The balancer: puts a process that arrives or ends its quantum in the queue of some CPU
+static void Place(Machine *machine, int process){
+
+	const Topology *topology = machine->topology;
+	int last = machine->tasks[process].lastCpu;
+	int cpu, target = 0;
+
+	//least loaded CPU, with affinity the closest to the last one among them
+	for(cpu = 1; cpu < topology->cpus; cpu++)
+		if(Load(machine, cpu) < Load(machine, target) ||
+		   (machine->affinity && last >= 0 && Load(machine, cpu) == Load(machine, target) &&
+			Distance(topology, last, cpu) < Distance(topology, last, target)))
+			target = cpu;
+
+	//with affinity stay on the last CPU unless it is clearly busier
+	if(machine->affinity && last >= 0 && Load(machine, last) <= Load(machine, target) + IMBALANCE)
+		target = last;
+
+	Queue(machine, target, process);
+}
+
+// Removes the best process of the queue of a CPU, returns -1 if the queue is empty
+static int Take(Machine *machine, int cpu){
+
+	RunQueue *queue = &machine->queues[cpu];
+	int process, last, position = 0, child;
+
+	if(!queue->size)
+		return -1;
+
+	process = queue->heap[0];
+	last = queue->heap[--queue->size];
+
+	//move the last process down from the top to its place
+	while((child = 2 * position + 1) < queue->size){
+
+		if(child + 1 < queue->size && Before(machine, queue->heap[child + 1], queue->heap[child]))
+			child++;
+
+		if(!Before(machine, queue->heap[child], last))
+			break;
+
+		queue->heap[position] = queue->heap[child];
+		position = child;
+	}
+
+	queue->heap[position] = last;
+
+	return process;
+}
+
+// Returns the best process of the queue of a CPU without removing it, -1 if the queue is empty
+static int Best(const Machine *machine, int cpu){
+
+	return machine->queues[cpu].size ? machine->queues[cpu].heap[0] : -1;
+}
+
+// An idle CPU with an empty queue takes a process from the longest queue, with affinity the closest of the
+// longest ones
+static int Steal(Machine *machine, int cpu){
+
+	const Topology *topology = machine->topology;
+	int other, victim = -1, length, longest = 0;
+
+	for(other = 0; other < topology->cpus; other++){
+
+		length = machine->queues[other].size;
+
+		if(other == cpu || length == 0)
+			continue;
+
+		if(length > longest || (machine->affinity && length == longest && Distance(topology, cpu, other) < Distance(topology, cpu, victim))){
+			victim = other;
+			longest = length;
+		}
+	}
+
+	return victim < 0 ? -1 : Take(machine, victim);
+}
+
+// Gives the CPU to a process, a process coming from another CPU pays the penalty of their distance
+static void Start(Machine *machine, int cpu, int process){
+
+	Task *task = &machine->tasks[process];
+	int distance;
+
+	if(task->lastCpu >= 0 && task->lastCpu != cpu){
+
+		distance = Distance(machine->topology, task->lastCpu, cpu);
+
+		machine->migrations[distance]++;
+		machine->cost += machine->topology->penalty[distance];
+		task->burstLeft += machine->topology->penalty[distance];
+	}
+
+	task->lastCpu = cpu;
+	task->slice = 0;
+	machine->running[cpu] = process;
+}
+
+// Runs every process to completion, from one arrival, completion or end of quantum to the next
+static void Simulate(Machine *machine){
+
+	const Job *jobs = machine->jobs;
+	int cpus = machine->topology->cpus;
+	int64_t step;
+	int next = 0, finished = 0, cpu, process, best, busy;
+
+	for(process = 0; process < machine->count; process++){
+		machine->tasks[process].burstLeft = jobs[process].burst;
+		machine->tasks[process].service = 0;
+		machine->tasks[process].lastCpu = -1;
+	}
+
+	for(cpu = 0; cpu < cpus; cpu++)
+		machine->running[cpu] = -1;
+
+	memset(machine->migrations, 0, sizeof(machine->migrations));
+	machine->timePassed = machine->cost = machine->busy = machine->totalWaitTime = 0;
+
+	while(finished < machine->count){
+
+		//processes arrive in the order of the list
+		while(next < machine->count && jobs[next].arriveTime <= machine->timePassed)
+			Place(machine, next++);
+
+		//processes leave the CPU at the end of their quantum or when a better one waits for it
+		for(cpu = 0; cpu < cpus; cpu++){
+
+			if((process = machine->running[cpu]) < 0)
+				continue;
+
+			if(machine->discipline->sliced && machine->tasks[process].slice >= machine->quantum){
+				machine->running[cpu] = -1;
+				Place(machine, process);
+			}
+
+			else if(machine->discipline->preemptive && (best = Best(machine, cpu)) >= 0 && Before(machine, best, process)){
+				machine->running[cpu] = -1;
+				Queue(machine, cpu, process);
+			}
+		}
+
+		//idle CPUs take the best process of their queue, those with nothing queued steal one afterwards
+		busy = 0;
+
+		for(cpu = 0; cpu < cpus; cpu++)
+			if(machine->running[cpu] < 0 && (process = Take(machine, cpu)) >= 0)
+				Start(machine, cpu, process);
+
+		for(cpu = 0; cpu < cpus; cpu++){
+
+			if(machine->running[cpu] < 0 && (process = Steal(machine, cpu)) >= 0)
+				Start(machine, cpu, process);
+
+			busy += machine->running[cpu] >= 0;
+		}
+
+		//nothing runs and nothing waits, jump straight to the next arrival
+		if(!busy){
+			machine->timePassed = jobs[next].arriveTime;
+			continue;
+		}
+
+		//run until the next arrival or until some process finishes or ends its quantum
+		step = next < machine->count ? jobs[next].arriveTime - machine->timePassed : INT64_MAX;
+
+		for(cpu = 0; cpu < cpus; cpu++){
+
+			if((process = machine->running[cpu]) < 0)
+				continue;
+
+			if(machine->tasks[process].burstLeft < step)
+				step = machine->tasks[process].burstLeft;
+
+			if(machine->discipline->sliced && machine->quantum - machine->tasks[process].slice < step)
+				step = machine->quantum - machine->tasks[process].slice;
+		}
+
+		machine->timePassed += step;
+
+		for(cpu = 0; cpu < cpus; cpu++){
+
+			if((process = machine->running[cpu]) < 0)
+				continue;
+
+			machine->tasks[process].burstLeft -= step;
+			machine->tasks[process].service += step;
+			machine->tasks[process].slice += step;
+			machine->busy += step;
+
+			if(machine->tasks[process].burstLeft == 0){
+
+				machine->totalWaitTime += machine->timePassed - jobs[process].burst - jobs[process].arriveTime;
+
+				if(machine->completion)
+					machine->completion[process] = machine->timePassed;
+
+				machine->running[cpu] = -1;
+				finished++;
+			}
+		}
+	}
+}
+
+// Prepares a run of the jobs on the machine of the topology, the policy and affinity are set before each run
+static void NewMachine(Machine *machine, const Topology *topology, const Job *jobs, int count, int64_t quantum){
+
+	machine->topology = topology;
+	machine->jobs = jobs;
+	machine->count = count;
+	machine->quantum = quantum;
+	machine->completion = NULL;
+	machine->tasks = g_new(Task, count);
+	machine->running = g_new(int, topology->cpus);
+	machine->queues = g_new0(RunQueue, topology->cpus);
+}
+
+static void FreeMachine(Machine *machine){
+
+	int cpu;
+
+	for(cpu = 0; cpu < machine->topology->cpus; cpu++)
+		g_free(machine->queues[cpu].heap);
+
+	g_free(machine->queues);
+	g_free(machine->running);
+	g_free(machine->tasks);
+}
+
+static void PrintRun(const char *label, const Machine *machine){
+
+	printf("    %-12s average wait time %f, %" PRId64 " migrations (%" PRId64 " core, %" PRId64 " socket, %" PRId64 " node), cost %" PRId64 " (%.2f%% of CPU time)\n",
+		   label, (double)machine->totalWaitTime / machine->count,
+		   machine->migrations[DISTANCE_CORE] + machine->migrations[DISTANCE_SOCKET] + machine->migrations[DISTANCE_NODE],
+		   machine->migrations[DISTANCE_CORE], machine->migrations[DISTANCE_SOCKET], machine->migrations[DISTANCE_NODE],
+		   machine->cost, machine->busy ? 100.0 * machine->cost / machine->busy : 0.0);
+}
+
+// Runs every policy on the machine of the topology file, with and without affinity, and prints
+// the average wait time and the migrations of each run
+int MultiCore(GList *list, int64_t quantum, const char *path){
+
+	Topology topology;
+	Machine machine;
+	Job *jobs;
+	int *pid, *priority;
+	int64_t *arriveTime, *burst;
+	Discipline discipline;
+	int count = g_list_length(list), i, policy;
+
+	if(ReadTopology(path, &topology) == EXIT_FAILURE)
+		return (EXIT_FAILURE);
+
+	pid = g_new(int, count);
+	priority = g_new(int, count);
+	arriveTime = g_new(int64_t, count);
+	burst = g_new(int64_t, count);
+	jobs = g_new(Job, count);
+
+	ProcessFields(list, pid, arriveTime, burst, priority);
+
+	for(i = 0; i < count; i++){
+
+		jobs[i].pid = pid[i];
+		jobs[i].priority = priority[i];
+		jobs[i].arriveTime = arriveTime[i];
+		jobs[i].burst = burst[i];
+
+		if(burst[i] < 1)
+			break;
+	}
+
+	g_free(pid);
+	g_free(priority);
+	g_free(arriveTime);
+	g_free(burst);
+
+	if(count == 0 || i < count || quantum < 1){
+		ErrorMsg("MultiCore", "needs processes with positive bursts and a positive quantum");
+		g_free(jobs);
+		return (EXIT_FAILURE);
+	}
+
+	NewMachine(&machine, &topology, jobs, count, quantum);
+
+	printf("%d CPUs: %d sockets, %d cores per socket, %d threads per core\n", topology.cpus, topology.sockets, topology.cores, topology.threads);
+	printf("Migration penalty: %" PRId64 " same core, %" PRId64 " same socket, %" PRId64 " other node\n\n",
+		   topology.penalty[DISTANCE_CORE], topology.penalty[DISTANCE_SOCKET], topology.penalty[DISTANCE_NODE]);
+
+	for(policy = 0; policy < NUM_DISCIPLINES; policy++){
+
+		discipline = policy < NUM_POLICIES ? FromPolicy(&policies[policy]) : fair;
+		machine.discipline = &discipline;
+
+		printf("%s on %d CPUs\n", discipline.name, topology.cpus);
+
+		machine.affinity = 1;
+		Simulate(&machine);
+		PrintRun("affinity:", &machine);
+
+		machine.affinity = 0;
+		Simulate(&machine);
+		PrintRun("no affinity:", &machine);
+
+		printf("\n");
+	}
+
+	FreeMachine(&machine);
+	g_free(jobs);
+
+	return (EXIT_SUCCESS);
+}
+
+// Runs a policy of main on a machine of one CPU, where nothing can migrate, and returns its average wait time.
+// The completion times have to be those of dispatcher.c, verify.c checks it
+double SingleCore(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion){
+
+	Topology topology = { 1, 1, 1, 1, { 0, 0, 0 } };
+	Discipline discipline = FromPolicy(policy);
+	Machine machine;
+
+	NewMachine(&machine, &topology, jobs, count, quantum);
+
+	machine.discipline = &discipline;
+	machine.affinity = 1;
+	machine.completion = completion;
+
+	Simulate(&machine);
+	FreeMachine(&machine);
+
+	return (double)machine.totalWaitTime / count;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: multicore.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Run the dispatcher policies on a machine with several CPUs and measure how much
+ *			time is lost when processes move between CPUs
+ *
+ * References:
+ *          Run queue per CPU with work stealing, like most multiprocessor schedulers
+ *
+ * Restrictions:
+ *          Include <stdint.h>, <glib.h>, dispatcher.h and engine.h before this header
+ *			The jobs given to SingleCore have to be in the order of main, by arrival and then pid
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *          Oct 18 2026 -- Added SingleCore
+ *
+ *
+ * Error handling:
+ *          MultiCore returns EXIT_FAILURE if the topology can not be read
+ *
+ * Notes:
+ *          Run with: scheduler -a topology.txt file.txt
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+int MultiCore(GList *list, int64_t quantum, const char *path);
+
+double SingleCore(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion);
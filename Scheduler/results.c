@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: results.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Write the results of every process and every policy as columns, in CSV or in a
+ *			compact binary format, through large buffered writes
+ *
+ * References:
+ *          The binary format keeps each column contiguous inside a block, like most columnar formats
+ *
+ * Restrictions:
+ *          Binary files use the byte order of the machine that wrote them
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          Functions return NULL or EXIT_FAILURE if a file can not be written
+ *
+ * File formats:
+ *          CSV files have a header line with the column names.
+ *
+ *          Binary files start with the magic "SCHDCOL1", the number of columns and, for every column,
+ *			its type, name and labels. Then come blocks of up to BLOCK_ROWS rows: the number of rows
+ *			followed by the values of each column, one column after the other. A block of 0 rows ends
+ *			the file. Counts, types and lengths are int32, strings are a length and their bytes.
+ *
+ *          Processes: policy, pid, arrival, burst, priority, completion, wait
+ *          Policies:  policy, processes, average_wait
+ *
+ * Notes:
+ *          Rows are written in the order of the completion arrays of dispatcher.c, which is the
+ *			arrival order of main
+ *
+ * $Id$
+ */
+
+#include <glib.h>				     /* Used for lists and g_new */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <stdio.h>                                /* Used for fwrite */
+#include <string.h>                                /* Used for memcpy */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <inttypes.h>                 /* Used for the PRId64 format */
+#include "FileIO.h"                               /* Used for ErrorMsg */
+#include "dispatcher.h"   /* Used for ProcessFields and the policies */
+#include "results.h"                               /* Function header */
+
+#define MAGIC          "SCHDCOL1"
+#define BLOCK_ROWS     65536
+#define FILE_BUFFER    (1 << 20)
+#define MAX_COLUMNS    8
+
+struct ColumnWriter {
+
+	FILE *fp;
+	int format;
+	int count;
+	Column columns[MAX_COLUMNS];
+	char *block[MAX_COLUMNS];		/* values of the current block, binary format only */
+	int rows;						/* rows in the current block */
+	int failed;
+
+};
+
+struct Results {
+
+	ColumnWriter *processes;
+	ColumnWriter *policies;
+
+	int size;
+	int *pid;
+	int64_t *arriveTime;
+	int64_t *burst;
+	int *priority;
+	int *policy;					/* the policy of every row, filled for every call */
+	int64_t *wait;
+
+};
+
+// Option names of the policies of main, labels of the policy columns, filled by OpenResults
+static const char *policyNames[NUM_POLICIES];
+
+static const Column processColumns[] = {
+	{ "policy",		COLUMN_INT32,	policyNames,	NUM_POLICIES },
+	{ "pid",		COLUMN_INT32,	NULL,			0 },
+	{ "arrival",	COLUMN_INT64,	NULL,			0 },
+	{ "burst",		COLUMN_INT64,	NULL,			0 },
+	{ "priority",	COLUMN_INT32,	NULL,			0 },
+	{ "completion",	COLUMN_INT64,	NULL,			0 },
+	{ "wait",		COLUMN_INT64,	NULL,			0 },
+};
+
+static const Column policyColumns[] = {
+	{ "policy",			COLUMN_INT32,	policyNames,	NUM_POLICIES },
+	{ "processes",		COLUMN_INT32,	NULL,			0 },
+	{ "average_wait",	COLUMN_DOUBLE,	NULL,			0 },
+};
+
+
+  //								 //
+ //          COLUMN WRITER          //
+//								   //
+
+
+static size_t Width(int type){
+
+	return type == COLUMN_INT32 ? sizeof(int32_t) : sizeof(int64_t);
+}
+
+static void WriteInt32(ColumnWriter *writer, int32_t value){
+
+	if(fwrite(&value, sizeof(value), 1, writer->fp) != 1)
+		writer->failed = 1;
+}
+
+static void WriteString(ColumnWriter *writer, const char *string){
+
+	WriteInt32(writer, (int32_t)strlen(string));
+
+	if(fwrite(string, 1, strlen(string), writer->fp) != strlen(string))
+		writer->failed = 1;
+}
+
+// Writes the current block of the binary format, every column one after the other
+static void FlushBlock(ColumnWriter *writer){
+
+	int column;
+
+	if(writer->rows == 0)
+		return;
+
+	WriteInt32(writer, writer->rows);
+
+	for(column = 0; column < writer->count; column++)
+		if(fwrite(writer->block[column], Width(writer->columns[column].type), writer->rows, writer->fp) != (size_t)writer->rows)
+			writer->failed = 1;
+
+	writer->rows = 0;
+}
+
+// Creates the file and writes the column names, returns NULL if it can not be created
+ColumnWriter* OpenColumns(const char *path, int format, const Column *columns, int count){
+
+	ColumnWriter *writer;
+	int column, label;
+
+	if(count > MAX_COLUMNS){
+		ErrorMsg("OpenColumns", "too many columns");
+		return NULL;
+	}
+
+	writer = g_new0(ColumnWriter, 1);
+	writer->fp = fopen(path, format == FORMAT_BINARY ? "wb" : "w");
+
+	if(!writer->fp){
+		ErrorMsg("OpenColumns", "can not create the results file");
+		g_free(writer);
+		return NULL;
+	}
+
+	//a large buffer so rows are written to the file in few system calls
+	setvbuf(writer->fp, NULL, _IOFBF, FILE_BUFFER);
+
+	writer->format = format;
+	writer->count = count;
+	memcpy(writer->columns, columns, count * sizeof(Column));
+
+	if(format == FORMAT_CSV){
+
+		for(column = 0; column < count; column++)
+			fprintf(writer->fp, "%s%s", column ? "," : "", columns[column].name);
+
+		fprintf(writer->fp, "\n");
+		return writer;
+	}
+
+	fwrite(MAGIC, 1, strlen(MAGIC), writer->fp);
+	WriteInt32(writer, count);
+
+	for(column = 0; column < count; column++){
+
+		WriteInt32(writer, columns[column].type);
+		WriteString(writer, columns[column].name);
+		WriteInt32(writer, columns[column].labelCount);
+
+		for(label = 0; label < columns[column].labelCount; label++)
+			WriteString(writer, columns[column].labels[label]);
+
+		writer->block[column] = g_malloc((size_t)BLOCK_ROWS * Width(columns[column].type));
+	}
+
+	return writer;
+}
+
+// Writes one value of a row in CSV
+static void WriteValue(ColumnWriter *writer, const Column *column, const void *values, int row){
+
+	int32_t value;
+
+	switch(column->type){
+
+		case COLUMN_INT32:
+
+			value = ((const int32_t*)values)[row];
+
+			if(value >= 0 && value < column->labelCount)
+				fputs(column->labels[value], writer->fp);
+			else
+				fprintf(writer->fp, "%d", value);
+			break;
+
+		case COLUMN_INT64:	fprintf(writer->fp, "%" PRId64, ((const int64_t*)values)[row]);	break;
+		case COLUMN_DOUBLE:	fprintf(writer->fp, "%f", ((const double*)values)[row]);		break;
+	}
+}
+
+// Adds rows to the file, values has an array of rows values for every column
+int WriteColumns(ColumnWriter *writer, int rows, const void * const *values){
+
+	int column, row, done, part;
+	size_t width;
+
+	if(writer->format == FORMAT_CSV){
+
+		for(row = 0; row < rows; row++){
+
+			for(column = 0; column < writer->count; column++){
+
+				if(column)
+					putc(',', writer->fp);
+
+				WriteValue(writer, &writer->columns[column], values[column], row);
+			}
+
+			putc('\n', writer->fp);
+		}
+
+		return ferror(writer->fp) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	//binary columns are only copied into the block, formatted by nobody
+	for(done = 0; done < rows; done += part){
+
+		part = rows - done;
+
+		if(part > BLOCK_ROWS - writer->rows)
+			part = BLOCK_ROWS - writer->rows;
+
+		for(column = 0; column < writer->count; column++){
+
+			width = Width(writer->columns[column].type);
+
+			memcpy(writer->block[column] + (size_t)writer->rows * width, (const char*)values[column] + (size_t)done * width, (size_t)part * width);
+		}
+
+		writer->rows += part;
+
+		if(writer->rows == BLOCK_ROWS)
+			FlushBlock(writer);
+	}
+
+	return writer->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Writes what is left and closes the file, returns EXIT_FAILURE if something could not be written
+int CloseColumns(ColumnWriter *writer){
+
+	int column, failed;
+
+	if(writer->format == FORMAT_BINARY){
+
+		FlushBlock(writer);
+		WriteInt32(writer, 0);
+
+		for(column = 0; column < writer->count; column++)
+			g_free(writer->block[column]);
+	}
+
+	failed = writer->failed || ferror(writer->fp);
+
+	if(fclose(writer->fp) || failed){
+		ErrorMsg("CloseColumns", "the results file could not be written");
+		g_free(writer);
+		return (EXIT_FAILURE);
+	}
+
+	g_free(writer);
+
+	return (EXIT_SUCCESS);
+}
+
+
+  //								 //
+ //          RESULTS OF MAIN        //
+//								   //
+
+
+// Opens prefix_processes and prefix_policies, .csv or .col, for the processes of the list
+Results* OpenResults(const char *prefix, int format, GList *list){
+
+	Results *results = g_new0(Results, 1);
+	const char *extension = format == FORMAT_BINARY ? "col" : "csv";
+	gchar *path;
+	int policy;
+
+	for(policy = 0; policy < NUM_POLICIES; policy++)
+		policyNames[policy] = policies[policy].option;
+
+	results->size = g_list_length(list);
+	results->pid = g_new(int, results->size);
+	results->arriveTime = g_new(int64_t, results->size);
+	results->burst = g_new(int64_t, results->size);
+	results->priority = g_new(int, results->size);
+	results->policy = g_new(int, results->size);
+	results->wait = g_new(int64_t, results->size);
+
+	ProcessFields(list, results->pid, results->arriveTime, results->burst, results->priority);
+
+	path = g_strdup_printf("%s_processes.%s", prefix, extension);
+	results->processes = OpenColumns(path, format, processColumns, 7);
+	g_free(path);
+
+	path = g_strdup_printf("%s_policies.%s", prefix, extension);
+	results->policies = OpenColumns(path, format, policyColumns, 3);
+	g_free(path);
+
+	if(!results->processes || !results->policies){
+		CloseResults(results);
+		return NULL;
+	}
+
+	return results;
+}
+
+// Writes the completion of every process and the average of a policy, returns the average so main can print it
+double WriteResults(Results *results, int policy, double average, const int64_t *completion){
+
+	const void *processValues[7], *policyValues[3];
+	int i;
+
+	if(!results)
+		return average;
+
+	for(i = 0; i < results->size; i++){
+		results->policy[i] = policy;
+		results->wait[i] = completion[i] - results->burst[i] - results->arriveTime[i];
+	}
+
+	processValues[0] = results->policy;
+	processValues[1] = results->pid;
+	processValues[2] = results->arriveTime;
+	processValues[3] = results->burst;
+	processValues[4] = results->priority;
+	processValues[5] = completion;
+	processValues[6] = results->wait;
+
+	policyValues[0] = &policy;
+	policyValues[1] = &results->size;
+	policyValues[2] = &average;
+
+	WriteColumns(results->processes, results->size, processValues);
+	WriteColumns(results->policies, 1, policyValues);
+
+	return average;
+}
+
+// Closes both files and frees the arrays, returns EXIT_FAILURE if some result could not be written
+int CloseResults(Results *results){
+
+	int status = EXIT_SUCCESS;
+
+	if(results->processes && CloseColumns(results->processes) == EXIT_FAILURE)
+		status = EXIT_FAILURE;
+
+	if(results->policies && CloseColumns(results->policies) == EXIT_FAILURE)
+		status = EXIT_FAILURE;
+
+	g_free(results->pid);
+	g_free(results->arriveTime);
+	g_free(results->burst);
+	g_free(results->priority);
+	g_free(results->policy);
+	g_free(results->wait);
+	g_free(results);
+
+	return status;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: results.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Write the results of every process and every policy as columns, in CSV or in a
+ *			compact binary format, through large buffered writes
+ *
+ * References:
+ *          Binary format described in results.c
+ *
+ * Restrictions:
+ *          Include <stdint.h> and <glib.h> before this header
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          Functions return NULL or EXIT_FAILURE if a file can not be written
+ *
+ * Notes:
+ *          A ColumnWriter takes whole columns at a time, the binary format only copies them
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the structures			              *
+ **************************************************************/
+
+#define FORMAT_CSV    0
+#define FORMAT_BINARY 1
+
+#define COLUMN_INT32  0
+#define COLUMN_INT64  1
+#define COLUMN_DOUBLE 2
+
+// Layout of a column, an int32 column with labels is written as the label of each value in CSV
+typedef struct {
+
+	const char *name;
+	int type;
+	const char * const *labels;
+	int labelCount;
+
+}Column;
+
+typedef struct ColumnWriter ColumnWriter;
+
+// Writers for the results of main, one file for the processes and one for the policies
+typedef struct Results Results;
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+ColumnWriter* OpenColumns(const char *path, int format, const Column *columns, int count);
+
+int WriteColumns(ColumnWriter *writer, int rows, const void * const *values);
+
+int CloseColumns(ColumnWriter *writer);
+
+Results* OpenResults(const char *prefix, int format, GList *list);
+
+double WriteResults(Results *results, int policy, double average, const int64_t *completion);
+
+int CloseResults(Results *results);
@@ -14,7 +14,47 @@
  *          numbers per line describing the process id, arrival time, 
  *          cpu burst and priority. The usage form is:
  *
- *          schedule file.txt
+ *          schedule [-c checkpoint] [-s seconds] [-o prefix [-f format]] [-a topology] file.txt
+ *          schedule -t workloads [-r seed]
+ *          schedule -m description.txt [-n replicas] [-j threads] [-p policies] [-r seed]
+ *          schedule -d socket [-j threads]
+ *          schedule -q socket
+ *
+ *          -c  Save the state of the simulation every few seconds to
+ *              the checkpoint file. If the file already exists the
+ *              simulation resumes from it. It is removed at the end.
+ *
+ *          -s  Seconds between checkpoints, 60 by default.
+ *
+ *          -o  Also write the completion and wait time of every process
+ *              under every policy to prefix_processes and the average of
+ *              every policy to prefix_policies (see results.c). Can not
+ *              be used with -c.
+ *
+ *          -f  Format of the -o files: csv, the default, or binary.
+ *
+ *          -a  After the usual results, run every policy on the machine
+ *              of the topology file (see multicore.c) and print the wait
+ *              time and the cost of migrations with and without affinity.
+ *
+ *          -t  Instead of reading a file, run the given number of random
+ *              workloads through engine.c, the multi-core model on one CPU
+ *              and dispatcher.c and check that they give the same results.
+ *              -r sets the random seed.
+ *
+ *          -m  Instead of reading a file, generate random workloads from
+ *              the description file (see montecarlo.c) and print the mean
+ *              average wait time of every policy with its confidence
+ *              interval. -n sets the number of replicas, 1000 by default,
+ *              -j the number of threads, every processor by default, and
+ *              -p the policies, a comma separated list of fcfs, npriority,
+ *              nsjf, priority, sjf and rr.
+ *
+ *          -d  Run as a daemon answering simulation requests on the Unix
+ *              socket (see server.c), -j sets the number of threads.
+ *
+ *          -q  Send the requests read from standard input to the daemon
+ *              listening on the socket and print its answers.
  *
  * References:
  *          The material that describe the scheduling algorithms is
@@ -34,6 +74,25 @@
  *          
  *          May 24 11:56 2012 - Code refactoring & big fixes
  *
+ *          Oct 18 2026 - Times and bursts are read as 64-bit integers
+ *
+ *          Oct 18 2026 - Added the -c and -s checkpoint options
+ *
+ *          Oct 18 2026 - Added the -t and -r verification options
+ *
+ *          Oct 18 2026 - Added the -m, -n, -j and -p Monte Carlo options
+ *
+ *          Oct 18 2026 - Added the -d daemon and -q query options
+ *
+ *          Oct 18 2026 - Added the -o and -f results options
+ *
+ *          Oct 18 2026 - Added the -a multi-core option
+ *
+ *          Oct 18 2026 - The policies are run from the table of dispatcher.h
+ *
+ *          Oct 18 2026 - The input file is read by LoadProcessList of
+ *                        dispatcher.c, shared with the daemon
+ *
  * Error handling:
  *          On any unrecoverable error, the program exits
  *
@@ -47,14 +106,23 @@
 #include <stdio.h>                                /* Used for fprintf */
 #include <string.h>                                /* Used for strcmp */
 #include <assert.h>                      /* Used for the assert macro */
+#include <stdint.h>                        /* Used for the int64_t type */
+#include <unistd.h>                             /* Used for getopt */
 #include "FileIO.h"    /* Definition of file access support functions */
 #include "dispatcher.h"/* Implementation of the dispatcher algorithms */
+#include "verify.h"   /* Differential test of the faster dispatcher */
+#include "montecarlo.h"     /* Evaluation of stochastic workloads */
+#include "server.h"           /* Daemon answering simulation requests */
+#include "results.h"          /* Columnar output of the results */
+#include "engine.h"            /* Jobs of the multi-core model */
+#include "multicore.h"     /* Migrations on a machine of several CPUs */
 
 /***********************************************************************
  *                       Global constant values                        *
  **********************************************************************/
-#define NUMPARAMS 2
-#define NUMVAL    4
+#define CHECKPOINT_SECONDS 60
+#define REPLICAS  1000
+#define STAGES    6                       /* Algorithms run on the file */
 
 
 /***********************************************************************
@@ -63,52 +131,128 @@
 int main (int argc, const char * argv[]) {
     
     FILE   *fp;                                /* Pointer to the file */
-    int    quantum = 0;              /* Quantum value for round robin */
+    int64_t quantum = 0;             /* Quantum value for round robin */
     GList  *processList_p = NULL;      /* Pointer to the process list */
-    int    parameters[NUMVAL];      /* Process parameters in the line */
-    int    i;                  /* Number of parameters in the process */
+    char   *error;                  /* Why the file could not be read */
+    int    option;                    /* Command line option being read */
+    int    policy;                        /* Policy of main being run */
+    const char *checkpoint = NULL;      /* Checkpoint file, if enabled */
+    int    seconds = CHECKPOINT_SECONDS;   /* Time between checkpoints */
+    int    workloads = 0;     /* Random workloads to verify, if any */
+    unsigned int seed = 1;           /* Seed of the random workloads */
+    const char *description = NULL;  /* Monte Carlo workload, if any */
+    int    replicas = REPLICAS;          /* Monte Carlo replicas to run */
+    int    threads = 0;          /* Threads for the replicas, 0 is all */
+    char   *selection = NULL;       /* Policies to run, NULL is all */
+    const char *daemonSocket = NULL;  /* Socket to listen on, if any */
+    const char *querySocket = NULL;  /* Socket of the daemon to query */
+    const char *prefix = NULL;     /* Prefix of the results files, if any */
+    int    format = FORMAT_CSV;          /* Format of the results files */
+    Results *results = NULL;          /* Results files, if enabled */
+    int64_t *completion = NULL;  /* Completion times, if results are on */
+    const char *topology = NULL;  /* Machine of the multi-core model */
+    
+    /* Read the options that come before the file name */
+    while ((option = getopt(argc, (char * const *)argv, "c:s:t:r:m:n:j:p:d:q:o:f:a:")) != -1) {
+        switch (option) {
+            case 'c':
+                checkpoint = optarg;
+                break;
+            case 's':
+                seconds = atoi(optarg);
+                break;
+            case 't':
+                workloads = atoi(optarg);
+                break;
+            case 'r':
+                seed = (unsigned int)strtoul(optarg, NULL, 10);
+                break;
+            case 'm':
+                description = optarg;
+                break;
+            case 'n':
+                replicas = atoi(optarg);
+                break;
+            case 'j':
+                threads = atoi(optarg);
+                break;
+            case 'p':
+                selection = optarg;
+                break;
+            case 'd':
+                daemonSocket = optarg;
+                break;
+            case 'q':
+                querySocket = optarg;
+                break;
+            case 'o':
+                prefix = optarg;
+                break;
+            case 'f':
+                if (!strcmp(optarg, "csv"))
+                    format = FORMAT_CSV;
+                else if (!strcmp(optarg, "binary"))
+                    format = FORMAT_BINARY;
+                else {
+                    printf("The -f option takes csv or binary\n");
+                    return (EXIT_FAILURE);
+                }
+                break;
+            case 'a':
+                topology = optarg;
+                break;
+            default:
+                printf("Usage: %s [-c checkpoint] [-s seconds] [-o prefix [-f csv|binary]] [-a topology] file.txt\n", argv[0]);
+                printf("       %s -t workloads [-r seed]\n", argv[0]);
+                printf("       %s -m description.txt [-n replicas] [-j threads] [-p policies] [-r seed]\n", argv[0]);
+                printf("       %s -d socket [-j threads]\n", argv[0]);
+                printf("       %s -q socket\n", argv[0]);
+                return (EXIT_FAILURE);
+        }
+    }
+    
+    /* Verification, Monte Carlo and the daemon do not need an input file */
+    if (workloads > 0)
+        return Verify(workloads, seed);
+    
+    if (description)
+        return MonteCarlo(description, replicas, threads, selection, seed);
+    
+    if (daemonSocket)
+        return Serve(daemonSocket, threads);
+    
+    if (querySocket)
+        return Query(querySocket);
+    
+    /* Resumed algorithms do not have the completion times of the processes */
+    if (checkpoint && prefix) {
+        printf("The -o option can not be used with -c\n");
+        return (EXIT_FAILURE);
+    }
     
     /* Check if the number of parameters is correct */
-    if (argc < NUMPARAMS){  
+    if (optind >= argc){  
         printf("Need a file with the process information\n");
         printf("Abnormal termination\n");
         return (EXIT_FAILURE);
     } else {
         /* Open the file and check that it exists */
-        fp = fopen (argv[1],"r");	  /* Open file for read operation */
+        fp = fopen (argv[optind],"r");  /* Open file for read operation */
         if (!fp) {                               /* There is an error */
             ErrorMsg("main","filename does not exist or is corrupted");
-        } else {
-            /* The first number in the file is the quantum */
-            quantum = GetInt(fp);
-            
-            if (quantum == EXIT_FAILURE) {
-                ErrorMsg("main","Quantum not found");
-            } else {
-                /*
-                 * Read the process information until the end of file
-                 * is reached.
-                 */
-                while (!feof(fp)){
-                    /* For every four parameters create a new process */
-                    for (i = 0; ((i < NUMVAL) && (!feof(fp))); i++) {
-                        parameters[i] = GetInt(fp);
-                    }
-                    
-                    /* Do we have four parameters? */
-                    if (i == NUMVAL) {
-                        processList_p = CreateProcess(processList_p,
-                                                       parameters[0],
-                                                       parameters[1],
-                                                       parameters[2],
-                                                       parameters[3]);      // ,NULL); why a NULL????
-                    }
-                }
-            }
+            return (EXIT_FAILURE);
         }
         
-        /* Start by sorting the processes by arrival time */
-        processList_p = SortProcessList(processList_p);
+        /*
+         * The first number in the file is the quantum, then every four
+         * numbers are a process. The list comes sorted by arrival time.
+         */
+        if (LoadProcessList(fp, &quantum, &processList_p, &error) == EXIT_FAILURE) {
+            ErrorMsg("main", error);
+            return (EXIT_FAILURE);
+        }
+        
+        fclose(fp);
         
 		        
 #ifdef DEBUG
@@ -116,27 +260,40 @@ int main (int argc, const char * argv[]) {
         PrintProcessList(processList_p);
         
 #endif
-        // Apply all the scheduling algorithms and print the results
+        /* Open the results files and record the completion times */
+        if (prefix) {
+            results = OpenResults(prefix, format, processList_p);
+            
+            if (!results)
+                return (EXIT_FAILURE);
+            
+            completion = g_new(int64_t, g_list_length(processList_p));
+        }
         
-		printf("FCFS average wait time is: ");							//FCFS 			-NonPreemptive
-        FirstCome (processList_p);									
-                        																												
-        printf("NonPreemtive priority average wait time is: ");			//Priority 		-NonPreemptive
-        NonPreemptive(processList_p, "priority"); 					    
-            				
-        printf("NonPreemtive SJF average wait time is: ");				//SJF 			-NonPreemptive
-        NonPreemptive(processList_p, "burst");									
-       					
-        printf("Preemtive priority average wait time is: ");			//Priority 		-Preemptive
-        Preemptive(processList_p, "priority");						
-
-        printf("Preemtive SJF average wait time is: ");					//SJF 			-Preemptive
-        Preemptive(processList_p, "burst");									
-        					
-        printf("RoundRobin average wait time is: ");					//RoundRobin 	-Preemptive
-        RoundRobin(processList_p, quantum);							
+        /* Resume from the checkpoint if there is one */
+        if (checkpoint)
+            SetCheckpoint(processList_p, checkpoint, seconds, STAGES);
+        
+        // Apply all the scheduling algorithms and print the results
+        for (policy = 0; policy < NUM_POLICIES; policy++) {
+            printf("%s average wait time is: ", policies[policy].name);
+            printf("%f\n\n", WriteResults(results, policy, RunPolicy(&policies[policy], processList_p, quantum, completion), completion));
+        }
 
 
+        /* Every algorithm finished, the checkpoint is no longer needed */
+        ClearCheckpoint();
+        
+        /* The same policies on several CPUs */
+        if (topology && MultiCore(processList_p, quantum, topology) == EXIT_FAILURE)
+            return (EXIT_FAILURE);
+        
+        /* Write what is left of the results */
+        if (results && CloseResults(results) == EXIT_FAILURE)
+            return (EXIT_FAILURE);
+        
+        g_free(completion);
+        
         /* Deallocate the memory assigned to the list */
         DestroyList(processList_p);
         
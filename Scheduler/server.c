@@ -0,0 +1,572 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: server.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Answer batches of simulation requests from other programs through a Unix domain socket,
+ *			keeping every workload already read in memory
+ *
+ * References:
+ *          Workloads are identified by the SHA-256 of the input file
+ *
+ * Restrictions:
+ *          Uses the dispatcher.c algorithms, which can run in parallel because checkpoints are off
+ *			At most MAX_WORKLOADS workloads stay cached, the least recently used one is dropped first
+ *			Only the user that started the daemon can connect to its socket
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *          Oct 18 2026 -- Files are read by LoadProcessList of dispatcher.c, run only takes hashes given by
+ *                         load, the cache is bounded and accept errors no longer make the daemon spin
+ *
+ *
+ * Error handling:
+ *          Serve and Query return EXIT_FAILURE if the socket can not be used, a request that fails
+ *			is answered with an error line and does not affect the others
+ *
+ * File formats:
+ *          A batch is one request per line ended by an empty line, the answers come back in the same
+ *			order, one per line, followed by an empty line:
+ *
+ *          load file.txt                   ok <hash> <processes> <quantum>
+ *          run <workload> <policy> [q]     ok <average wait time>
+ *
+ *          The workload of run is the hash given by load, run never reads a file and needs no I/O at all.
+ *			Policies are fcfs, npriority, nsjf, priority, sjf and rr, q replaces the quantum of the file.
+ *			A failed request is answered with: error <message>
+ *
+ * Notes:
+ *          Every connection has its own thread, the requests of a batch are shared by a pool of
+ *			threads so a batch takes about as long as its slowest request
+ *
+ * $Id$
+ */
+
+#include <glib.h>	   /* Used for lists, threads, hash tables and checksums */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <stdio.h>                                /* Used for printf */
+#include <string.h>                                /* Used for strcmp */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <errno.h>                       /* Used for accept errors */
+#include <inttypes.h>                 /* Used for the SCNd64 format */
+#include <signal.h>                         /* Used to ignore SIGPIPE */
+#include <unistd.h>                                /* Used for unlink */
+#include <sys/socket.h>                   /* Used for the Unix socket */
+#include <sys/un.h>                           /* Used for sockaddr_un */
+#include <sys/stat.h>                       /* Used for lstat and umask */
+#include "FileIO.h"                               /* Used for ErrorMsg */
+#include "dispatcher.h"         /* Algorithms run for every request */
+#include "server.h"                                /* Function header */
+
+#define MAX_REPLY 256
+#define BACKLOG   16
+#define MAX_WORKLOADS 64			/* workloads kept in the cache */
+#define ACCEPT_RETRY  100000		/* microseconds to wait when no descriptor is left for a connection */
+
+// Input file already read, never changed once it is in the cache
+typedef struct {
+
+	GList *list;
+	int64_t quantum;
+	int size;
+	int users;						/* requests running on it, it is freed once evicted and unused */
+	int evicted;
+
+}Workload;
+
+// Requests of a connection that have not been answered yet
+typedef struct {
+
+	GMutex mutex;
+	GCond done;
+	int pending;
+
+}Batch;
+
+// One request of a batch and its answer
+typedef struct {
+
+	Batch *batch;
+	char *request;
+	char reply[MAX_REPLY];
+
+}Task;
+
+static GHashTable *cache;			/* Workload of every hash */
+static GQueue *recent;				/* hashes of the cache, the least recently used first */
+static GMutex cacheMutex;
+static GThreadPool *pool;
+
+
+  //								 //
+ //         WORKLOAD CACHE          //
+//								   //
+
+
+// Reads the processes the same way main does, from a file already in memory
+static Workload* ParseWorkload(gchar *contents, gsize length, char **error){
+
+	Workload *workload;
+	FILE *fp = fmemopen(contents, length, "r");
+
+	if(!fp){
+		*error = "can not read the file";
+		return NULL;
+	}
+
+	workload = g_new0(Workload, 1);
+
+	if(LoadProcessList(fp, &workload->quantum, &workload->list, error) == EXIT_FAILURE){
+		g_free(workload);
+		workload = NULL;
+	}
+	else
+		workload->size = g_list_length(workload->list);
+
+	fclose(fp);
+
+	return workload;
+}
+
+static void FreeWorkload(Workload *workload){
+
+	DestroyList(workload->list);
+	g_free(workload);
+}
+
+// Moves a hash to the end of the recently used ones, the cache mutex has to be held
+static void Touch(gchar *hash){
+
+	g_queue_remove(recent, hash);
+	g_queue_push_tail(recent, hash);
+}
+
+// Returns the cached workload of a hash and marks it in use, NULL if it is not cached
+static Workload* FindWorkload(const char *hash){
+
+	Workload *workload;
+	gpointer key;
+
+	g_mutex_lock(&cacheMutex);
+
+	if(g_hash_table_lookup_extended(cache, hash, &key, (gpointer*)&workload)){
+		workload->users++;
+		Touch(key);
+	}
+	else
+		workload = NULL;
+
+	g_mutex_unlock(&cacheMutex);
+
+	return workload;
+}
+
+// Ends a use of a workload given by FindWorkload, frees it if it was evicted meanwhile
+static void ReleaseWorkload(Workload *workload){
+
+	int unused;
+
+	g_mutex_lock(&cacheMutex);
+	unused = --workload->users == 0 && workload->evicted;
+	g_mutex_unlock(&cacheMutex);
+
+	if(unused)
+		FreeWorkload(workload);
+}
+
+// Adds a workload to the cache, dropping the least recently used one if it is full. The cache mutex has to be held
+static void CacheWorkload(const char *hash, Workload *workload){
+
+	Workload *evicted;
+	gchar *oldest;
+
+	if(g_hash_table_size(cache) >= MAX_WORKLOADS){
+
+		oldest = g_queue_pop_head(recent);
+		evicted = g_hash_table_lookup(cache, oldest);
+		g_hash_table_remove(cache, oldest);
+
+		//a request still running on it frees it when it ends
+		evicted->evicted = 1;
+
+		if(evicted->users == 0)
+			FreeWorkload(evicted);
+	}
+
+	oldest = g_strdup(hash);
+	g_hash_table_insert(cache, oldest, workload);
+	g_queue_push_tail(recent, oldest);
+}
+
+// Reads a file and caches its workload, only parsed if no file with the same contents is cached.
+// Fills the hash, the number of processes and the quantum, returns NULL or the reason it failed
+static char* LoadWorkload(const char *path, char *hash, int *size, int64_t *quantum){
+
+	Workload *workload, *parsed;
+	gchar *contents, *checksum;
+	gsize length;
+	char *error = NULL;
+
+	if(!g_file_get_contents(path, &contents, &length, NULL))
+		return "can not read the file";
+
+	checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar*)contents, length);
+	strcpy(hash, checksum);
+
+	if(!(workload = FindWorkload(checksum)) && (parsed = ParseWorkload(contents, length, &error))){
+
+		//another request may have parsed the same file meanwhile, keep the first one
+		g_mutex_lock(&cacheMutex);
+
+		if(!(workload = g_hash_table_lookup(cache, checksum))){
+			workload = parsed;
+			parsed = NULL;
+			CacheWorkload(checksum, workload);
+		}
+
+		workload->users++;
+		g_mutex_unlock(&cacheMutex);
+
+		if(parsed)
+			FreeWorkload(parsed);
+	}
+
+	if(workload){
+		*size = workload->size;
+		*quantum = workload->quantum;
+		ReleaseWorkload(workload);
+	}
+
+	g_free(checksum);
+	g_free(contents);
+
+	return error;
+}
+
+
+  //								 //
+ //            REQUESTS             //
+//								   //
+
+
+// Answers a single request, the algorithms only read the cached list so any number can run at once
+static void Answer(const char *request, char *reply){
+
+	char command[MAX_REPLY], name[MAX_REPLY], option[MAX_REPLY];
+	char hash[MAX_REPLY] = "";
+	char *error;
+	Workload *workload;
+	int64_t quantum;
+	double average = 0;
+	int fields, policy, size = 0;
+
+	fields = sscanf(request, "%255s %255s %255s %" SCNd64, command, name, option, &quantum);
+
+	if(fields >= 2 && !strcmp(command, "load")){
+
+		if((error = LoadWorkload(name, hash, &size, &quantum)))
+			snprintf(reply, MAX_REPLY, "error %s: %.200s", error, name);
+		else
+			snprintf(reply, MAX_REPLY, "ok %s %d %" PRId64, hash, size, quantum);
+
+		return;
+	}
+
+	if(fields < 3 || strcmp(command, "run")){
+		snprintf(reply, MAX_REPLY, "error unknown request, use load or run");
+		return;
+	}
+
+	if((policy = FindPolicy(option)) < 0){
+		snprintf(reply, MAX_REPLY, "error unknown policy, use fcfs, npriority, nsjf, priority, sjf or rr");
+		return;
+	}
+
+	//only workloads given by load can run, a request never makes the daemon read a file
+	if(!(workload = FindWorkload(name))){
+		snprintf(reply, MAX_REPLY, "error unknown workload %.200s, load it first", name);
+		return;
+	}
+
+	if(fields < 4)
+		quantum = workload->quantum;
+
+	if(workload->size == 0)
+		snprintf(reply, MAX_REPLY, "error the workload has no processes");
+
+	else if(policies[policy].algorithm == ALG_ROUNDROBIN && quantum < 1)
+		snprintf(reply, MAX_REPLY, "error the quantum must be positive");
+
+	else{
+		average = RunPolicy(&policies[policy], workload->list, quantum, NULL);
+		snprintf(reply, MAX_REPLY, "ok %f", average);
+	}
+
+	ReleaseWorkload(workload);
+}
+
+// Runs in the pool, answers one task and wakes up its connection when it is the last of the batch
+static void RunTask(gpointer data, gpointer unused){
+
+	Task *task = data;
+	Batch *batch = task->batch;
+
+	(void)unused;
+
+	Answer(task->request, task->reply);
+
+	g_mutex_lock(&batch->mutex);
+
+	if(--batch->pending == 0)
+		g_cond_signal(&batch->done);
+
+	g_mutex_unlock(&batch->mutex);
+}
+
+// Reads the batches of a connection until it is closed, answering every batch once all its requests are done
+static gpointer Connection(gpointer data){
+
+	int socket = GPOINTER_TO_INT(data);
+	FILE *in = fdopen(socket, "r");
+	FILE *out = fdopen(dup(socket), "w");
+	GPtrArray *tasks = g_ptr_array_new();
+	Batch batch;
+	Task *task;
+	char *line = NULL;
+	size_t capacity = 0;
+	ssize_t length;
+	guint i;
+
+	g_mutex_init(&batch.mutex);
+	g_cond_init(&batch.done);
+
+	while(in && out){
+
+		length = getline(&line, &capacity, in);
+
+		if(length > 0 && line[length - 1] == '\n')
+			line[--length] = '\0';
+
+		//a request, keep reading until the batch is complete
+		if(length > 0){
+
+			task = g_new(Task, 1);
+			task->batch = &batch;
+			task->request = g_strdup(line);
+			g_ptr_array_add(tasks, task);
+			continue;
+		}
+
+		if(length < 0 && tasks->len == 0)
+			break;
+
+		//an empty line or the end of the connection completes the batch
+		if(tasks->len > 0){
+
+			batch.pending = tasks->len;
+
+			for(i = 0; i < tasks->len; i++)
+				g_thread_pool_push(pool, g_ptr_array_index(tasks, i), NULL);
+
+			g_mutex_lock(&batch.mutex);
+
+			while(batch.pending > 0)
+				g_cond_wait(&batch.done, &batch.mutex);
+
+			g_mutex_unlock(&batch.mutex);
+
+			for(i = 0; i < tasks->len; i++){
+
+				task = g_ptr_array_index(tasks, i);
+				fprintf(out, "%s\n", task->reply);
+
+				g_free(task->request);
+				g_free(task);
+			}
+
+			g_ptr_array_set_size(tasks, 0);
+		}
+
+		fprintf(out, "\n");
+
+		if(fflush(out) || length < 0)
+			break;
+	}
+
+	g_cond_clear(&batch.done);
+	g_mutex_clear(&batch.mutex);
+	g_ptr_array_free(tasks, TRUE);
+	free(line);
+
+	if(in)
+		fclose(in);
+	else
+		close(socket);
+
+	if(out)
+		fclose(out);
+
+	return NULL;
+}
+
+// Fills the address of the socket, returns EXIT_FAILURE if the name is too long
+static int SocketAddress(const char *path, struct sockaddr_un *address){
+
+	memset(address, 0, sizeof(*address));
+	address->sun_family = AF_UNIX;
+
+	if(strlen(path) >= sizeof(address->sun_path)){
+		ErrorMsg("SocketAddress", "socket name is too long");
+		return (EXIT_FAILURE);
+	}
+
+	strcpy(address->sun_path, path);
+
+	return (EXIT_SUCCESS);
+}
+
+// Listens on the socket until the program is killed, with the given number of threads for the requests,
+// 0 uses every processor
+int Serve(const char *path, int threads){
+
+	struct sockaddr_un address;
+	struct stat status;
+	mode_t mask;
+	int listener, connection, bound;
+
+	if(SocketAddress(path, &address) == EXIT_FAILURE)
+		return (EXIT_FAILURE);
+
+	if(threads < 1)
+		threads = g_get_num_processors();
+
+	//a client that disconnects early must not kill the daemon
+	signal(SIGPIPE, SIG_IGN);
+
+	//remove the socket of a previous daemon, but never a file that is not a socket
+	if(lstat(path, &status) == 0){
+
+		if(!S_ISSOCK(status.st_mode)){
+			ErrorMsg("Serve", "the path exists and is not a socket");
+			return (EXIT_FAILURE);
+		}
+
+		if(unlink(path)){
+			ErrorMsg("Serve", "can not remove the socket of a previous daemon");
+			return (EXIT_FAILURE);
+		}
+	}
+
+	listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	//only the user running the daemon can connect, requests make it read files
+	mask = umask(0177);
+	bound = listener >= 0 && !bind(listener, (struct sockaddr*)&address, sizeof(address));
+	umask(mask);
+
+	if(!bound || listen(listener, BACKLOG)){
+		ErrorMsg("Serve", "can not listen on the socket");
+		return (EXIT_FAILURE);
+	}
+
+	cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	recent = g_queue_new();
+	pool = g_thread_pool_new(RunTask, NULL, threads, FALSE, NULL);
+
+	printf("Listening on %s with %d threads\n", path, threads);
+	fflush(stdout);
+
+	for(;;){
+
+		if((connection = accept(listener, NULL, NULL)) >= 0)
+			g_thread_unref(g_thread_new("connection", Connection, GINT_TO_POINTER(connection)));
+
+		//out of descriptors or memory, wait for some connection to close instead of retrying at once
+		else if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+			g_usleep(ACCEPT_RETRY);
+
+		//a client that gave up before being accepted does not stop the daemon, anything else does
+		else if(errno != EINTR && errno != ECONNABORTED){
+			ErrorMsg("Serve", "can not accept connections");
+			close(listener);
+			return (EXIT_FAILURE);
+		}
+	}
+}
+
+// Sends the requests read from standard input to the daemon and prints its answers, an empty line
+// sends the batch read so far, so does the end of the input
+int Query(const char *path){
+
+	struct sockaddr_un address;
+	int server;
+	FILE *in, *out;
+	char *line = NULL;
+	size_t capacity = 0;
+	ssize_t length = 0;
+	int requests, status = EXIT_SUCCESS;
+
+	if(SocketAddress(path, &address) == EXIT_FAILURE)
+		return (EXIT_FAILURE);
+
+	server = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if(server < 0 || connect(server, (struct sockaddr*)&address, sizeof(address))){
+		ErrorMsg("Query", "can not connect to the daemon");
+		return (EXIT_FAILURE);
+	}
+
+	in = fdopen(server, "r");
+	out = fdopen(dup(server), "w");
+
+	while(length >= 0){
+
+		//send one batch
+		requests = 0;
+
+		while((length = getline(&line, &capacity, stdin)) > 0 && line[0] != '\n'){
+
+			fputs(line, out);
+			requests++;
+
+			if(line[length - 1] != '\n')
+				fprintf(out, "\n");
+		}
+
+		if(requests == 0)
+			continue;
+
+		fprintf(out, "\n");
+		fflush(out);
+
+		//print its answers, the empty line that ends them included
+		while((length = getline(&line, &capacity, in)) > 0){
+
+			fputs(line, stdout);
+
+			if(line[0] == '\n')
+				break;
+		}
+
+		fflush(stdout);
+
+		if(length < 0){
+			ErrorMsg("Query", "the daemon closed the connection");
+			status = EXIT_FAILURE;
+			break;
+		}
+
+		length = feof(stdin) ? -1 : 0;
+	}
+
+	free(line);
+	fclose(in);
+	fclose(out);
+
+	return status;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: server.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Answer batches of simulation requests from other programs through a Unix domain socket,
+ *			keeping every workload already read in memory
+ *
+ * References:
+ *          Protocol described in server.c
+ *
+ * Restrictions:
+ *          Uses the dispatcher.c algorithms, which can run in parallel because checkpoints are off
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          Serve and Query return EXIT_FAILURE if the socket can not be used
+ *
+ * Notes:
+ *          Run with: scheduler -d socket [-j threads] and query with: scheduler -q socket < requests
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+int Serve(const char *path, int threads);
+
+int Query(const char *path);
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: verify.c
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Differential test of engine.c and of the one CPU model of multicore.c against the list based
+ *			algorithms of dispatcher.c
+ *
+ * References:
+ *          Shrinking is a simple version of delta debugging
+ *
+ * Restrictions:
+ *          Generated workloads have unique pids and positive bursts and quantum, see engine.h
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *          Oct 18 2026 -- multicore.c on one CPU is checked too, for the six policies of main
+ *
+ *          Oct 18 2026 -- The reproducer is read back with LoadProcessList, main has to run the same workload from it
+ *
+ *
+ * Error handling:
+ *          Verify returns EXIT_FAILURE and prints the smallest failing input found
+ *
+ * Notes:
+ *          Every random workload is run through every policy with every implementation and the
+ *			completion time of every process has to be the same. Workloads are small and use few
+ *			distinct bursts, priorities and arrivals so that ties, where the algorithms differ most
+ *			easily, happen all the time
+ *
+ * $Id$
+ */
+
+#include <glib.h>				 /* Used for linked lists and GRand */
+#include <stdlib.h>                     /* Used for malloc definition */
+#include <stdio.h>                                /* Used for printf */
+#include <string.h>                                /* Used for memcpy */
+#include <stdint.h>                    /* Used for the int64_t type */
+#include <inttypes.h>                 /* Used for the PRId64 format */
+#include "dispatcher.h"         /* Reference dispatcher algorithms */
+#include "engine.h"               /* Algorithms being verified */
+#include "multicore.h"           /* One CPU model being verified */
+#include "verify.h"                                /* Function header */
+
+#define MAX_JOBS 40
+
+// Preemptive with an unknown criteria keeps the list order, checked besides the six policies of main
+static const Policy listOrder = { "Preemtive list order", "none", ALG_PREEMPTIVE, "none" };
+
+#define NUM_CHECKED (NUM_POLICIES + 1)
+
+static const Policy* Checked(int policy){
+
+	return policy < NUM_POLICIES ? &policies[policy] : &listOrder;
+}
+
+// compare by time of arrival, if same time by pid, the order main gives to the list
+static int compareJobs(const void *a, const void *b){
+
+	const Job *first = a, *second = b;
+
+	if(first->arriveTime != second->arriveTime)
+		return first->arriveTime < second->arriveTime ? -1 : 1;
+
+	return (first->pid > second->pid) - (first->pid < second->pid);
+}
+
+// Runs the list based algorithm, the list is built in the order of the array
+static void RunReference(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion){
+
+	GList *list = NULL;
+	int i;
+
+	for(i = 0; i < count; i++)
+		list = CreateProcess(list, jobs[i].pid, jobs[i].arriveTime, jobs[i].burst, jobs[i].priority);
+
+	RunPolicy(policy, list, quantum, completion);
+
+	DestroyList(list);
+}
+
+// Workspace shared by every engine run, workloads never have more than MAX_JOBS jobs
+static EngineWorkspace *workspace;
+
+static void RunEngine(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion){
+
+	EngineRunPolicy(policy, jobs, count, quantum, completion, workspace);
+}
+
+static void RunSingleCore(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion){
+
+	SingleCore(policy, jobs, count, quantum, completion);
+}
+
+// An implementation checked against dispatcher.c
+typedef struct {
+
+	char *name;
+	void (*run)(const Policy *policy, const Job *jobs, int count, int64_t quantum, int64_t *completion);
+	int policies;					/* number of policies it runs, the first ones of Checked */
+
+}Candidate;
+
+// The list order case of Preemptive is not a policy of main, so multicore.c does not have it
+static const Candidate candidates[] = {
+	{ "engine.c",				RunEngine,		NUM_CHECKED },
+	{ "multicore.c on one CPU",	RunSingleCore,	NUM_POLICIES },
+};
+
+#define NUM_CANDIDATES ((int)(sizeof(candidates) / sizeof(candidates[0])))
+
+// Implementation being checked
+static const Candidate *candidate;
+
+// Returns 1 if the implementation being checked finishes some process at a different time than dispatcher.c
+static int Differs(const Policy *policy, const Job *jobs, int count, int64_t quantum){
+
+	int64_t reference[MAX_JOBS], checked[MAX_JOBS];
+
+	RunReference(policy, jobs, count, quantum, reference);
+	candidate->run(policy, jobs, count, quantum, checked);
+
+	return memcmp(reference, checked, count * sizeof(int64_t)) != 0;
+}
+
+// Random workload, the spread of every field is random too so some workloads are full of ties and others of idle gaps
+static int Generate(GRand *rand, Job *jobs, int64_t *quantum){
+
+	int count = g_rand_int_range(rand, 1, MAX_JOBS + 1);
+	int gap = g_rand_int_range(rand, 1, 20);
+	int burst = g_rand_int_range(rand, 1, 12);
+	int priority = g_rand_int_range(rand, 1, 6);
+	int64_t arriveTime = 0;
+	int i, other, pid;
+
+	for(i = 0; i < count; i++){
+
+		arriveTime += g_rand_int_range(rand, 0, gap);
+
+		jobs[i].pid = i + 1;
+		jobs[i].arriveTime = arriveTime;
+		jobs[i].burst = g_rand_int_range(rand, 1, burst + 1);
+		jobs[i].priority = g_rand_int_range(rand, 0, priority);
+	}
+
+	//shuffle the pids so they do not follow the arrival order
+	for(i = count - 1; i > 0; i--){
+		other = g_rand_int_range(rand, 0, i + 1);
+		pid = jobs[i].pid;
+		jobs[i].pid = jobs[other].pid;
+		jobs[other].pid = pid;
+	}
+
+	*quantum = g_rand_int_range(rand, 1, burst + 2);
+
+	qsort(jobs, count, sizeof(Job), compareJobs);
+
+	return count;
+}
+
+// Tries a smaller version of the workload, keeps it if it still fails
+static int Attempt(const Policy *policy, Job *jobs, int *count, int64_t *quantum, const Job *candidate, int candidateCount, int64_t candidateQuantum){
+
+	Job sorted[MAX_JOBS];
+
+	memcpy(sorted, candidate, candidateCount * sizeof(Job));
+	qsort(sorted, candidateCount, sizeof(Job), compareJobs);
+
+	if(candidateCount < 1 || candidateQuantum < 1 || !Differs(policy, sorted, candidateCount, candidateQuantum))
+		return 0;
+
+	memcpy(jobs, sorted, candidateCount * sizeof(Job));
+	*count = candidateCount;
+	*quantum = candidateQuantum;
+
+	return 1;
+}
+
+// Returns 1 if no other job uses the pid
+static int FreePid(const Job *jobs, int count, int pid){
+
+	int i;
+
+	for(i = 0; i < count; i++)
+		if(jobs[i].pid == pid)
+			return 0;
+
+	return 1;
+}
+
+// Removes jobs and lowers values while the workload still fails, until nothing else can be removed or lowered
+static void Shrink(const Policy *policy, Job *jobs, int *count, int64_t *quantum){
+
+	Job candidate[MAX_JOBS];
+	int64_t values[3];
+	int changed = 1, i, j, pid;
+
+	while(changed){
+
+		changed = 0;
+
+		//remove one job at a time
+		for(i = 0; i < *count; i++){
+
+			memcpy(candidate, jobs, i * sizeof(Job));
+			memcpy(candidate + i, jobs + i + 1, (*count - i - 1) * sizeof(Job));
+
+			if(Attempt(policy, jobs, count, quantum, candidate, *count - 1, *quantum)){
+				changed = 1;
+				i--;
+			}
+		}
+
+		//lower the quantum
+		values[0] = 1; values[1] = *quantum / 2; values[2] = *quantum - 1;
+
+		for(j = 0; j < 3; j++)
+			if(values[j] < *quantum && Attempt(policy, jobs, count, quantum, jobs, *count, values[j]))
+				changed = 1;
+
+		//move every arrival so the first job arrives at 0, lowering one arrival at a time would break ties
+		if(jobs[0].arriveTime > 0){
+
+			for(i = 0; i < *count; i++){
+				candidate[i] = jobs[i];
+				candidate[i].arriveTime -= jobs[0].arriveTime;
+			}
+
+			if(Attempt(policy, jobs, count, quantum, candidate, *count, *quantum))
+				changed = 1;
+		}
+
+		//lower the fields of every job, a change re-sorts the array so the outer loop makes another pass
+		for(i = 0; i < *count; i++){
+
+			values[0] = 1; values[1] = jobs[i].burst / 2; values[2] = jobs[i].burst - 1;
+
+			for(j = 0; j < 3; j++){
+				memcpy(candidate, jobs, *count * sizeof(Job));
+				candidate[i].burst = values[j];
+				if(values[j] >= 1 && values[j] < jobs[i].burst && Attempt(policy, jobs, count, quantum, candidate, *count, *quantum))
+					changed = 1;
+			}
+
+			values[0] = 0; values[1] = jobs[i].arriveTime / 2; values[2] = jobs[i].arriveTime - 1;
+
+			for(j = 0; j < 3; j++){
+				memcpy(candidate, jobs, *count * sizeof(Job));
+				candidate[i].arriveTime = values[j];
+				if(values[j] >= 0 && values[j] < jobs[i].arriveTime && Attempt(policy, jobs, count, quantum, candidate, *count, *quantum))
+					changed = 1;
+			}
+
+			values[0] = 0; values[1] = jobs[i].priority / 2; values[2] = jobs[i].priority - 1;
+
+			for(j = 0; j < 3; j++){
+				memcpy(candidate, jobs, *count * sizeof(Job));
+				candidate[i].priority = values[j];
+				if(values[j] >= 0 && values[j] < jobs[i].priority && Attempt(policy, jobs, count, quantum, candidate, *count, *quantum))
+					changed = 1;
+			}
+
+			for(pid = 1; pid < jobs[i].pid; pid++){
+				if(!FreePid(jobs, *count, pid))
+					continue;
+				memcpy(candidate, jobs, *count * sizeof(Job));
+				candidate[i].pid = pid;
+				if(Attempt(policy, jobs, count, quantum, candidate, *count, *quantum)){
+					changed = 1;
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Returns 1 if LoadProcessList, the reader of main, gets back the same workload from the input
+static int ReadsBack(const Job *jobs, int count, int64_t quantum, char *input, size_t length){
+
+	int pid[MAX_JOBS], priority[MAX_JOBS];
+	int64_t arriveTime[MAX_JOBS], burst[MAX_JOBS], loadedQuantum;
+	FILE *fp = fmemopen(input, length, "r");
+	GList *list = NULL;
+	char *error;
+	int same, i;
+
+	if(!fp)
+		return 0;
+
+	same = LoadProcessList(fp, &loadedQuantum, &list, &error) == EXIT_SUCCESS &&
+		   loadedQuantum == quantum && (int)g_list_length(list) == count;
+
+	fclose(fp);
+
+	if(same){
+
+		ProcessFields(list, pid, arriveTime, burst, priority);
+
+		for(i = 0; i < count; i++)
+			if(pid[i] != jobs[i].pid || arriveTime[i] != jobs[i].arriveTime || burst[i] != jobs[i].burst || priority[i] != jobs[i].priority)
+				same = 0;
+	}
+
+	DestroyList(list);
+
+	return same;
+}
+
+// Prints the workload as an input file followed by both completion times of every process
+static void PrintReproducer(const Policy *policy, const Job *jobs, int count, int64_t quantum){
+
+	int64_t reference[MAX_JOBS], checked[MAX_JOBS];
+	char *input;
+	size_t length;
+	FILE *fp;
+	int i;
+
+	RunReference(policy, jobs, count, quantum, reference);
+	candidate->run(policy, jobs, count, quantum, checked);
+
+	printf("# %s differs on this input\n", policy->name);
+	printf("# pid: completion in dispatcher.c, completion in %s\n", candidate->name);
+
+	for(i = 0; i < count; i++)
+		printf("# %d: %" PRId64 ", %" PRId64 "%s\n", jobs[i].pid, reference[i], checked[i], reference[i] != checked[i] ? "  <--" : "");
+
+	if(!(fp = open_memstream(&input, &length)))
+		return;
+
+	fprintf(fp, "%" PRId64 "\n", quantum);
+
+	for(i = 0; i < count; i++)
+		fprintf(fp, "%d %" PRId64 " %" PRId64 " %d\n", jobs[i].pid, jobs[i].arriveTime, jobs[i].burst, jobs[i].priority);
+
+	fclose(fp);
+
+	//the input is only useful if main runs the same workload from it
+	if(!ReadsBack(jobs, count, quantum, input, length))
+		printf("# main does not read this input as the workload that failed\n");
+
+	printf("%s", input);
+	free(input);
+}
+
+// Runs the given number of random workloads through every implementation, returns EXIT_SUCCESS if they always agree
+int Verify(int workloads, unsigned int seed){
+
+	GRand *rand = g_rand_new_with_seed(seed);
+	Job jobs[MAX_JOBS];
+	int64_t quantum;
+	int count, i, policy, checked;
+
+	workspace = NewWorkspace(MAX_JOBS);
+
+	for(i = 0; i < workloads; i++){
+
+		count = Generate(rand, jobs, &quantum);
+
+		for(checked = 0; checked < NUM_CANDIDATES; checked++)
+		for(policy = 0; policy < candidates[checked].policies; policy++){
+
+			candidate = &candidates[checked];
+
+			if(!Differs(Checked(policy), jobs, count, quantum))
+				continue;
+
+			printf("Workload %d of seed %u fails in %s, shrinking it\n\n", i, seed, candidate->name);
+
+			Shrink(Checked(policy), jobs, &count, &quantum);
+			PrintReproducer(Checked(policy), jobs, count, quantum);
+
+			FreeWorkspace(workspace);
+			g_rand_free(rand);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	printf("%d workloads of seed %u, %d policies: engine.c and, for the %d of main, multicore.c on one CPU match dispatcher.c\n",
+		   workloads, seed, NUM_CHECKED, NUM_POLICIES);
+
+	FreeWorkspace(workspace);
+	g_rand_free(rand);
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File name: verify.h
+ *
+ * Author:  Gustavo Martin 	A01362246
+ *
+ *
+ * Purpose: Differential test of engine.c and of the one CPU model of multicore.c against the list based
+ *			algorithms of dispatcher.c
+ *
+ * References:
+ *          Shrinking is a simple version of delta debugging
+ *
+ * Restrictions:
+ *          Generated workloads have unique pids and positive bursts and quantum, see engine.h
+ *
+ * Revision history:
+ *
+ *          Oct 18 2026 -- File created
+ *
+ *
+ * Error handling:
+ *          Verify returns EXIT_FAILURE and prints the smallest failing input found
+ *
+ * Notes:
+ *          Run with: scheduler -t workloads [-r seed]
+ *
+ * $Id$
+ */
+
+/**************************************************************
+ *             Declare the functions			              *
+ **************************************************************/
+
+int Verify(int workloads, unsigned int seed);